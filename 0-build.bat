@@ -85,14 +85,15 @@ echo Compiling WASM module (cpu6510 + SID processor + PNG converter + reSID audi
 echo.
 
 pushd wasm
-call emcc cpu6510_wasm.cpp sid_processor.cpp png_converter.cpp sid_audio.cpp ^
+call emcc cpu6510_wasm.cpp sid_processor.cpp sid_relocator.cpp png_converter.cpp sid_audio.cpp ^
     resid\sid.cc resid\voice.cc resid\wave.cc resid\envelope.cc ^
     resid\filter8580new.cc resid\extfilt.cc ^
     resid\pot.cc resid\dac.cc resid\version.cc ^
     -I. ^
     -O3 ^
+    -msimd128 ^
     -s WASM=1 ^
-    -s EXPORTED_FUNCTIONS="['_cpu_init','_cpu_load_memory','_cpu_read_memory','_cpu_write_memory','_cpu_step','_cpu_execute_function','_cpu_get_pc','_cpu_set_pc','_cpu_get_sp','_cpu_get_a','_cpu_get_x','_cpu_get_y','_cpu_get_cycles','_cpu_get_memory_access','_cpu_get_sid_writes','_cpu_get_total_sid_writes','_cpu_get_sid_chip_count','_cpu_get_sid_chip_address','_cpu_get_zp_writes','_cpu_get_total_zp_writes','_cpu_set_record_writes','_cpu_set_tracking','_cpu_get_write_sequence_length','_cpu_get_write_sequence_item','_cpu_analyze_memory','_cpu_get_last_write_pc','_sid_init','_sid_load','_sid_analyze','_sid_get_header_string','_sid_get_header_value','_sid_set_header_string','_sid_create_modified','_sid_get_modified_count','_sid_get_modified_address','_sid_get_zp_count','_sid_get_zp_address','_sid_get_code_bytes','_sid_get_data_bytes','_sid_get_sid_writes','_sid_get_sid_chip_count','_sid_get_sid_chip_address','_sid_get_clock_type','_sid_get_sid_model','_sid_cleanup','_png_converter_init','_png_converter_set_image','_png_converter_convert','_png_converter_create_c64_bitmap','_png_converter_get_background_color','_png_converter_get_bitmap_mode','_png_converter_get_color_stats','_png_converter_get_map_data','_png_converter_get_scr_data','_png_converter_get_col_data','_png_converter_set_palette','_png_converter_get_palette_count','_png_converter_get_palette_name','_png_converter_get_current_palette','_png_converter_get_palette_color','_png_converter_cleanup','_audio_init','_audio_load_sid','_audio_set_subtune','_audio_generate','_audio_set_model','_audio_set_sampling_method','_audio_get_title','_audio_get_author','_audio_get_copyright','_audio_get_subtune_count','_audio_get_default_subtune','_audio_get_sid_model','_audio_get_sid_count','_audio_get_play_time','_audio_get_is_ntsc','_audio_cleanup','_allocate_memory','_free_memory','_malloc','_free']" ^
+    -s EXPORTED_FUNCTIONS="['_cpu_init','_cpu_load_memory','_cpu_read_memory','_cpu_write_memory','_cpu_step','_cpu_execute_function','_cpu_get_pc','_cpu_set_pc','_cpu_get_sp','_cpu_get_a','_cpu_get_x','_cpu_get_y','_cpu_get_cycles','_cpu_get_memory_access','_cpu_is_instruction_start','_cpu_is_data_read','_cpu_get_sid_writes','_cpu_get_total_sid_writes','_cpu_get_sid_chip_count','_cpu_get_sid_chip_address','_cpu_get_zp_writes','_cpu_get_total_zp_writes','_cpu_set_record_writes','_cpu_set_tracking','_cpu_get_write_sequence_length','_cpu_get_write_sequence_item','_cpu_analyze_memory','_cpu_get_last_write_pc','_cpu_begin_epoch','_cpu_get_liveness','_cpu_is_play_live','_cpu_get_first_use','_cpu_get_last_use','_cpu_get_zp_operand_span','_cpu_get_zp_flags','_cpu_is_zp_pointer','_cpu_is_zp_unpatchable','_cpu_get_timer_write_count','_cpu_get_timer_write_epoch','_cpu_get_timer_write_latch','_sid_init','_sid_load','_sid_analyze','_sid_get_header_string','_sid_get_header_value','_sid_set_header_string','_sid_create_modified','_sid_get_modified_count','_sid_get_modified_address','_sid_get_live_count','_sid_get_live_address','_sid_get_reclaim_range_count','_sid_get_reclaim_range_start','_sid_get_reclaim_range_end','_sid_get_zp_count','_sid_get_zp_address','_sid_get_zp_first_use','_sid_get_zp_last_use','_sid_get_zp_flags','_sid_zp_clear_reserved','_sid_zp_reserve','_sid_zp_solve','_sid_get_zp_remap','_sid_get_zp_patch_count','_sid_get_zp_patch_address','_sid_get_zp_patch_value','_sid_get_zp_unverified_count','_sid_get_speed_profile','_sid_get_song_calls_per_frame','_sid_get_song_cia_timer','_sid_get_song_timer_change_count','_sid_get_song_timer_change_call','_sid_get_song_timer_change_latch','_sid_relocate','_sid_get_relocated_data','_sid_get_relocated_size','_sid_get_relocated_address','_sid_get_relocation_patch_count','_sid_get_relocation_unverified_count','_sid_get_relocation_untraced_count','_sid_get_relocation_ambiguous_offset','_sid_get_relocation_mismatch_song','_sid_get_relocation_mismatch_frame','_sid_get_code_bytes','_sid_get_data_bytes','_sid_get_sid_writes','_sid_get_sid_chip_count','_sid_get_sid_chip_address','_sid_get_clock_type','_sid_get_sid_model','_sid_cleanup','_png_converter_init','_png_converter_set_image','_png_converter_convert','_png_converter_create_c64_bitmap','_png_converter_get_background_color','_png_converter_get_bitmap_mode','_png_converter_get_color_stats','_png_converter_get_map_data','_png_converter_get_scr_data','_png_converter_get_col_data','_png_converter_set_palette','_png_converter_get_palette_count','_png_converter_get_palette_name','_png_converter_get_current_palette','_png_converter_get_palette_color','_png_converter_cleanup','_audio_init','_audio_load_sid','_audio_set_subtune','_audio_generate','_audio_generate_f32','_audio_set_chip_pan','_audio_set_chip_gain','_audio_render_begin','_audio_render','_audio_seek','_audio_seek_prepare','_audio_set_seek_interval','_audio_set_voice_taps','_audio_get_voice_tap_count','_audio_set_register_stream','_audio_get_register_frame_count','_audio_set_quality_governor','_audio_get_sampling_method','_audio_get_render_load','_audio_create','_audio_destroy','_audio_select','_audio_crossfade_f32','_audio_dump_capture','_audio_dump_data','_audio_get_stats','_audio_set_silence_detection','_audio_get_end_status','_audio_get_silent_time','_audio_set_model','_audio_set_sampling_method','_audio_get_title','_audio_get_author','_audio_get_copyright','_audio_get_subtune_count','_audio_get_default_subtune','_audio_get_sid_model','_audio_get_sid_count','_audio_get_play_time','_audio_get_is_ntsc','_audio_cleanup','_allocate_memory','_free_memory','_malloc','_free']" ^
     -s EXPORTED_RUNTIME_METHODS="['ccall','cwrap','getValue','setValue','HEAP8','HEAP16','HEAP32','HEAPU8','HEAPU16','HEAPU32','HEAPF32','HEAPF64']" ^
     -s MODULARIZE=1 ^
     -s EXPORT_NAME="SIDwinderModule" ^
@@ -100,7 +101,7 @@ call emcc cpu6510_wasm.cpp sid_processor.cpp png_converter.cpp sid_audio.cpp ^
     -s INITIAL_MEMORY=33554432 ^
     -s MAXIMUM_MEMORY=67108864 ^
     -s NO_EXIT_RUNTIME=1 ^
-    -s ENVIRONMENT="web" ^
+    -s ENVIRONMENT="web,worker" ^
     -s SINGLE_FILE=0 ^
     -o "..\public\sidwinder.js"
 popd
@@ -0,0 +1,105 @@
+// sidbench: speed of reSID's resampling (the FIR convolution it runs per
+// output sample) on both chip models at 44.1 and 48 kHz.
+//
+//   sidbench [seconds]
+//
+// Each case clocks one chip playing a held three-voice chord through the
+// filter for the given length of C64 time (default 2 s) with the resample
+// method, then again with interpolate, which skips the FIR; the best of
+// nine runs of each is reported. The difference
+// is the convolution's own cost per output sample. Build once as is and
+// once with -DRESID_SIMD=OFF to compare the SIMD kernel with the scalar loop.
+
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "resid/sid.h"
+
+namespace {
+
+	const double CLOCK = 985248.0;  // PAL
+	const int BLOCK = 4096;         // samples per clock() call
+	const int RUNS = 9;             // best of
+
+	const char* KernelName() {
+#if RESID_SIMD && defined(__wasm_simd128__)
+		return "WASM SIMD128";
+#elif RESID_SIMD && (defined(__SSE2__) || defined(_M_X64))
+		return "SSE2";
+#elif RESID_SIMD && defined(__ARM_NEON)
+		return "NEON";
+#else
+		return "scalar";
+#endif
+	}
+
+	// Nanoseconds of CPU time per output sample, for one run.
+	double TimeRun(reSID::chip_model model, reSID::sampling_method method,
+		double rate, double seconds) {
+		reSID::SID sid;
+		sid.set_chip_model(model);
+		sid.set_sampling_parameters(CLOCK, method, rate);
+		sid.reset();
+
+		// Saw, pulse and noise held at full sustain, low-pass with resonance.
+		const reSID::reg8 regs[][2] = {
+			{ 0x00, 0x00 }, { 0x01, 0x11 }, { 0x05, 0x00 }, { 0x06, 0xF0 }, { 0x04, 0x21 },
+			{ 0x07, 0x00 }, { 0x08, 0x16 }, { 0x0C, 0x00 }, { 0x0D, 0xF0 },
+			{ 0x09, 0x00 }, { 0x0A, 0x08 }, { 0x0B, 0x41 },
+			{ 0x0E, 0x00 }, { 0x0F, 0x40 }, { 0x13, 0x00 }, { 0x14, 0xA0 }, { 0x12, 0x81 },
+			{ 0x15, 0x00 }, { 0x16, 0x40 }, { 0x17, 0xF7 }, { 0x18, 0x1F },
+		};
+		for (const auto& r : regs) {
+			sid.write(r[0], r[1]);
+		}
+
+		std::vector<short> buffer(BLOCK);
+		reSID::cycle_count left = (reSID::cycle_count)(seconds * CLOCK);
+		long long samples = 0;
+		std::clock_t start = std::clock();
+		while (left > 0) {
+			samples += sid.clock(left, buffer.data(), BLOCK);
+		}
+		double ns = double(std::clock() - start) * 1e9 / CLOCKS_PER_SEC;
+		return samples > 0 ? ns / samples : 0.0;
+	}
+
+	double TimeMethod(reSID::chip_model model, reSID::sampling_method method,
+		double rate, double seconds) {
+		double best = 0.0;
+		for (int run = 0; run < RUNS; run++) {
+			double ns = TimeRun(model, method, rate, seconds);
+			if (run == 0 || ns < best) {
+				best = ns;
+			}
+		}
+		return best;
+	}
+
+}
+
+int main(int argc, char** argv) {
+	double seconds = argc > 1 ? std::atof(argv[1]) : 2.0;
+	if (seconds <= 0) {
+		std::fprintf(stderr, "Usage: sidbench [seconds]\n");
+		return 1;
+	}
+
+	std::printf("FIR kernel: %s, %.0f s of C64 time per case\n\n", KernelName(), seconds);
+	std::printf("model  rate     resample    interpolate  FIR alone   (ns per output sample)\n");
+
+	const reSID::chip_model models[] = { reSID::MOS6581, reSID::MOS8580 };
+	const double rates[] = { 44100.0, 48000.0 };
+	for (reSID::chip_model model : models) {
+		for (double rate : rates) {
+			double resample = TimeMethod(model, reSID::SAMPLE_RESAMPLE, rate, seconds);
+			double interpolate = TimeMethod(model, reSID::SAMPLE_INTERPOLATE, rate, seconds);
+			std::printf("%-6s %-8.0f %8.1f    %8.1f     %8.1f\n",
+				model == reSID::MOS6581 ? "6581" : "8580", rate,
+				resample, interpolate, resample - interpolate);
+		}
+	}
+	return 0;
+}
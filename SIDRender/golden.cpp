@@ -0,0 +1,479 @@
+// sidgolden: golden-output regression and speed check for the playback
+// engine (wasm/sid_audio.cpp and reSID, built natively as for sidrender).
+//
+//   sidgolden [options] <reference.txt>
+//
+// The reference file lists the cases, one per line ('#' starts a comment):
+//
+//   <tune.sid> <6581|8580> <fast|interpolate|resample> <seconds> [<hash> <excerpt>]
+//
+// with tune paths relative to the reference file. Each case renders the
+// tune's start song as 16-bit stereo PCM, as sidrender writes it but
+// without the fade, and compares a hash of the whole render with the stored
+// one. When they differ, a short excerpt from the middle of the render is
+// compared sample by sample, so rounding-level drift can be told apart
+// from a real change (see --tolerance). --update stores fresh hashes and
+// excerpts. Speed is reported per case and overall, as output samples per
+// second and nanoseconds of wall time per emulated cycle.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Engine exports (wasm/sid_audio.cpp)
+extern "C" {
+	void audio_init(double sampleRate);
+	int audio_load_sid(const uint8_t* data, int length);
+	void audio_set_subtune(int subtune);
+	void audio_set_model(int model);
+	void audio_set_sampling_method(int method);
+	int audio_get_default_subtune();
+	double audio_render_begin(double seconds, int format, double fadeSeconds);
+	int audio_render(uint8_t* out, int capacity);
+	int audio_get_stats(double* out, int reset);  // AudioStats: doubles, emulated cycles first
+	void audio_cleanup();
+}
+
+namespace {
+
+	const double SAMPLE_RATE = 48000.0;
+	const int RENDER_FORMAT = 1;          // 16-bit stereo
+	const int WAV_HEADER_BYTES = 44;
+	const int EXCERPT_FRAMES = 256;       // stereo frames kept from the middle of each render
+	const int STATS_FIELDS = 32;          // room for audio_get_stats
+
+	const char* const METHOD_NAMES[] = { "fast", "interpolate", "resample" };
+
+	struct Case {
+		size_t line;              // index into the reference file's lines
+		std::string tune;
+		int model = 0;
+		int method = 0;
+		double seconds = 0.0;
+		std::string hash;         // stored; empty if none yet
+		std::string excerpt;
+	};
+
+	struct CaseResult {
+		bool ok = false;
+		std::string error;        // rendering failed
+		std::string hash;
+		std::string excerpt;
+		int maxDiff = 0;          // excerpt vs stored, when the hashes differ
+		double rmsDiff = 0.0;
+		double renderSeconds = 0.0;
+		double frames = 0.0;
+		double cycles = 0.0;
+	};
+
+	std::mutex g_printMutex;
+
+	void PrintUsage(const char* exe) {
+		std::fprintf(stderr,
+			"Usage: %s [options] <reference.txt>\n"
+			"\n"
+			"Options:\n"
+			"  --update               Store the current output as the reference.\n"
+			"  --tolerance <n>        Accept a changed render if no excerpt sample moved\n"
+			"                         by more than n (default 0: bit-exact only).\n"
+			"  -j, --jobs <n>         Cases rendered in parallel (default: CPU count;\n"
+			"                         use 1 for speed figures to compare).\n",
+			exe);
+	}
+
+	bool ReadFile(const std::string& path, std::vector<uint8_t>& data) {
+		FILE* f = std::fopen(path.c_str(), "rb");
+		if (!f)
+			return false;
+		std::fseek(f, 0, SEEK_END);
+		long size = std::ftell(f);
+		std::fseek(f, 0, SEEK_SET);
+		data.resize(size > 0 ? (size_t)size : 0);
+		bool ok = size > 0 && std::fread(data.data(), 1, data.size(), f) == data.size();
+		std::fclose(f);
+		return ok;
+	}
+
+	bool ReadLines(const std::string& path, std::vector<std::string>& lines) {
+		std::vector<uint8_t> data;
+		if (!ReadFile(path, data))
+			return false;
+		std::string line;
+		for (uint8_t c : data) {
+			if (c == '\n') {
+				lines.push_back(line);
+				line.clear();
+			}
+			else if (c != '\r')
+				line += (char)c;
+		}
+		if (!line.empty())
+			lines.push_back(line);
+		return true;
+	}
+
+	std::string Directory(const std::string& path) {
+		size_t slash = path.find_last_of("/\\");
+		return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+	}
+
+	// Fields of a case line; false for comments and blank lines
+	bool ParseCase(const std::string& line, Case& c, std::string& error) {
+		std::vector<std::string> fields;
+		size_t pos = 0;
+		while (pos < line.size()) {
+			if (line[pos] == '#')
+				break;
+			if (line[pos] == ' ' || line[pos] == '\t') {
+				++pos;
+				continue;
+			}
+			size_t end = line.find_first_of(" \t#", pos);
+			if (end == std::string::npos)
+				end = line.size();
+			fields.push_back(line.substr(pos, end - pos));
+			pos = end;
+		}
+		if (fields.empty())
+			return false;
+
+		if (fields.size() != 4 && fields.size() != 6) {
+			error = "expected <tune> <model> <method> <seconds> [<hash> <excerpt>]";
+			return false;
+		}
+		c.tune = fields[0];
+		c.model = std::atoi(fields[1].c_str());
+		c.method = -1;
+		for (int m = 0; m < 3; ++m) {
+			if (fields[2] == METHOD_NAMES[m])
+				c.method = m;
+		}
+		c.seconds = std::atof(fields[3].c_str());
+		if ((c.model != 6581 && c.model != 8580) || c.method < 0 || c.seconds <= 0.0) {
+			error = "bad model, method or length";
+			return false;
+		}
+		if (fields.size() == 6) {
+			c.hash = fields[4];
+			c.excerpt = fields[5];
+		}
+		return true;
+	}
+
+	uint64_t Fnv1a64(const uint8_t* data, size_t length) {
+		uint64_t h = 0xCBF29CE484222325ull;
+		for (size_t i = 0; i < length; ++i)
+			h = (h ^ data[i]) * 0x100000001B3ull;
+		return h;
+	}
+
+	// Samples as 4 hex digits each (two's complement)
+	std::string EncodeExcerpt(const int16_t* samples, int count) {
+		static const char HEX[] = "0123456789abcdef";
+		std::string text;
+		text.reserve(count * 4);
+		for (int i = 0; i < count; ++i) {
+			uint16_t v = (uint16_t)samples[i];
+			for (int shift = 12; shift >= 0; shift -= 4)
+				text += HEX[(v >> shift) & 15];
+		}
+		return text;
+	}
+
+	bool DecodeExcerpt(const std::string& text, std::vector<int16_t>& samples) {
+		if (text.size() % 4 != 0)
+			return false;
+		samples.clear();
+		for (size_t i = 0; i < text.size(); i += 4) {
+			char* end = nullptr;
+			std::string digits = text.substr(i, 4);
+			unsigned long v = std::strtoul(digits.c_str(), &end, 16);
+			if (*end != 0)
+				return false;
+			samples.push_back((int16_t)(uint16_t)v);
+		}
+		return true;
+	}
+
+	// Runs on a worker thread; the engine state is thread-local.
+	CaseResult RenderCase(const Case& c, const std::string& baseDir) {
+		CaseResult result;
+		std::vector<uint8_t> data;
+		if (!ReadFile(baseDir + c.tune, data)) {
+			result.error = "cannot read " + c.tune;
+			return result;
+		}
+
+		audio_init(SAMPLE_RATE);
+		int rc = audio_load_sid(data.data(), (int)data.size());
+		if (rc != 0) {
+			result.error = "not a valid SID file (error " + std::to_string(rc) + ")";
+			return result;
+		}
+		audio_set_model(c.model);
+		audio_set_sampling_method(c.method);
+		audio_set_subtune(audio_get_default_subtune() - 1);
+		if (audio_render_begin(c.seconds, RENDER_FORMAT, 0.0) < 0) {
+			result.error = "bad render length";
+			audio_cleanup();
+			return result;
+		}
+
+		std::vector<uint8_t> pcm;
+		std::vector<uint8_t> chunk(1 << 16);
+		auto start = std::chrono::steady_clock::now();
+		int n;
+		while ((n = audio_render(chunk.data(), (int)chunk.size())) > 0)
+			pcm.insert(pcm.end(), chunk.begin(), chunk.begin() + n);
+		result.renderSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		double stats[STATS_FIELDS] = {};
+		audio_get_stats(stats, 0);
+		result.cycles = stats[0];
+		audio_cleanup();
+
+		if (pcm.size() < (size_t)WAV_HEADER_BYTES) {
+			result.error = "no output";
+			return result;
+		}
+		const uint8_t* body = pcm.data() + WAV_HEADER_BYTES;
+		size_t bodyBytes = pcm.size() - WAV_HEADER_BYTES;
+		size_t frames = bodyBytes / 4;
+		result.frames = (double)frames;
+
+		char hash[17];
+		std::snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)Fnv1a64(body, bodyBytes));
+		result.hash = hash;
+
+		// The excerpt, from the middle (samples are little-endian in the WAV)
+		size_t first = frames > (size_t)EXCERPT_FRAMES ? (frames - EXCERPT_FRAMES) / 2 : 0;
+		int count = (int)std::min(frames, (size_t)EXCERPT_FRAMES) * 2;
+		std::vector<int16_t> excerpt(count);
+		for (int i = 0; i < count; ++i) {
+			const uint8_t* p = body + first * 4 + i * 2;
+			excerpt[i] = (int16_t)(p[0] | (p[1] << 8));
+		}
+		result.excerpt = EncodeExcerpt(excerpt.data(), count);
+
+		if (!c.hash.empty() && c.hash != result.hash) {
+			std::vector<int16_t> stored;
+			if (!DecodeExcerpt(c.excerpt, stored) || stored.size() != excerpt.size()) {
+				result.maxDiff = INT32_MAX;
+			}
+			else {
+				double sum = 0.0;
+				for (size_t i = 0; i < stored.size(); ++i) {
+					int d = std::abs(stored[i] - excerpt[i]);
+					result.maxDiff = std::max(result.maxDiff, d);
+					sum += (double)d * d;
+				}
+				result.rmsDiff = std::sqrt(sum / std::max<size_t>(stored.size(), 1));
+			}
+		}
+		result.ok = true;
+		return result;
+	}
+
+	std::string CaseName(const Case& c) {
+		std::string name = c.tune;
+		size_t slash = name.find_last_of("/\\");
+		if (slash != std::string::npos)
+			name = name.substr(slash + 1);
+		size_t dot = name.find_last_of('.');
+		if (dot != std::string::npos)
+			name = name.substr(0, dot);
+		return name + " " + std::to_string(c.model) + " " + METHOD_NAMES[c.method];
+	}
+
+	bool ParseNumber(const char* text, double& value) {
+		char* end = nullptr;
+		value = std::strtod(text, &end);
+		return end != text && *end == 0;
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	bool update = false;
+	int tolerance = 0;
+	int jobs = (int)std::thread::hardware_concurrency();
+	std::string referencePath;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--help" || arg == "-h") {
+			PrintUsage(argv[0]);
+			return 0;
+		}
+		if (arg == "--update") {
+			update = true;
+			continue;
+		}
+		if (arg.size() > 1 && arg[0] == '-') {
+			if (i + 1 >= argc) {
+				std::fprintf(stderr, "Error: %s needs an argument.\n", arg.c_str());
+				return 1;
+			}
+			const char* value = argv[++i];
+			double number = 0.0;
+			bool numeric = ParseNumber(value, number);
+
+			if (arg == "--tolerance" && numeric && number >= 0)
+				tolerance = (int)number;
+			else if ((arg == "-j" || arg == "--jobs") && numeric && number >= 1)
+				jobs = (int)number;
+			else {
+				std::fprintf(stderr, "Error: bad option %s %s\n", arg.c_str(), value);
+				return 1;
+			}
+		}
+		else if (referencePath.empty())
+			referencePath = arg;
+		else {
+			PrintUsage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (referencePath.empty()) {
+		PrintUsage(argv[0]);
+		return 1;
+	}
+
+	std::vector<std::string> lines;
+	if (!ReadLines(referencePath, lines)) {
+		std::fprintf(stderr, "Error: cannot read %s\n", referencePath.c_str());
+		return 1;
+	}
+	std::vector<Case> cases;
+	for (size_t i = 0; i < lines.size(); ++i) {
+		Case c;
+		std::string error;
+		if (ParseCase(lines[i], c, error)) {
+			c.line = i;
+			cases.push_back(c);
+		}
+		else if (!error.empty()) {
+			std::fprintf(stderr, "%s:%zu: %s\n", referencePath.c_str(), i + 1, error.c_str());
+			return 1;
+		}
+	}
+	if (cases.empty()) {
+		std::fprintf(stderr, "Error: no cases in %s\n", referencePath.c_str());
+		return 1;
+	}
+	jobs = std::max(1, std::min(jobs, (int)cases.size()));
+	std::string baseDir = Directory(referencePath);
+
+	// reSID's waveform and envelope generators fill their shared tables,
+	// unlocked, in their first constructor; run that here, before any worker
+	// thread constructs its own engine. The filter's gain tables are built
+	// per chip model on first use, under a lock, so workers may do that.
+	audio_init(SAMPLE_RATE);
+
+	std::fprintf(stderr, "%s %zu case(s) on %d thread(s)...\n",
+		update ? "Recording" : "Checking", cases.size(), jobs);
+
+	std::vector<CaseResult> results(cases.size());
+	std::atomic<size_t> next{ 0 };
+	std::atomic<size_t> done{ 0 };
+
+	auto worker = [&]() {
+		for (size_t i = next++; i < cases.size(); i = next++) {
+			const Case& c = cases[i];
+			CaseResult& r = results[i] = RenderCase(c, baseDir);
+
+			std::string verdict;
+			if (!r.ok)
+				verdict = "ERROR " + r.error;
+			else if (update)
+				verdict = "recorded";
+			else if (c.hash.empty())
+				verdict = "FAIL no reference";
+			else if (r.hash == c.hash)
+				verdict = "OK";
+			else {
+				char text[96];
+				std::snprintf(text, sizeof(text), "%s max %d rms %.2f",
+					r.maxDiff <= tolerance ? "DIFF" : "FAIL", r.maxDiff, r.rmsDiff);
+				verdict = text;
+			}
+
+			std::lock_guard<std::mutex> lock(g_printMutex);
+			if (r.ok) {
+				std::fprintf(stderr, "[%2zu/%zu] %-48s %-24s %6.2f Msamples/s %6.1f ns/cycle\n",
+					++done, cases.size(), CaseName(c).c_str(), verdict.c_str(),
+					r.frames / std::max(r.renderSeconds, 1e-9) / 1e6,
+					r.renderSeconds * 1e9 / std::max(r.cycles, 1.0));
+			}
+			else {
+				std::fprintf(stderr, "[%2zu/%zu] %-48s %s\n",
+					++done, cases.size(), CaseName(c).c_str(), verdict.c_str());
+			}
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (int t = 1; t < jobs; ++t)
+		threads.emplace_back(worker);
+	worker();
+	for (std::thread& t : threads)
+		t.join();
+
+	size_t exact = 0, tolerated = 0, failed = 0;
+	double frames = 0.0, cycles = 0.0, seconds = 0.0;
+	for (size_t i = 0; i < cases.size(); ++i) {
+		const Case& c = cases[i];
+		const CaseResult& r = results[i];
+		if (!r.ok) {
+			++failed;
+			continue;
+		}
+		frames += r.frames;
+		cycles += r.cycles;
+		seconds += r.renderSeconds;
+		if (update)
+			lines[c.line] = c.tune + " " + std::to_string(c.model) + " " + METHOD_NAMES[c.method] + " "
+				+ std::to_string((int)c.seconds) + " " + r.hash + " " + r.excerpt;
+		else if (!c.hash.empty() && r.hash == c.hash)
+			++exact;
+		else if (!c.hash.empty() && r.maxDiff <= tolerance)
+			++tolerated;
+		else
+			++failed;
+	}
+
+	std::fprintf(stderr, "\nSpeed: %.2f Msamples/s, %.1f ns/cycle (render time summed over cases).\n",
+		frames / std::max(seconds, 1e-9) / 1e6, seconds * 1e9 / std::max(cycles, 1.0));
+
+	if (update) {
+		if (failed > 0) {
+			std::fprintf(stderr, "Not updated: %zu case(s) failed to render.\n", failed);
+			return 1;
+		}
+		FILE* out = std::fopen(referencePath.c_str(), "wb");
+		bool writeOk = out != nullptr;
+		for (size_t i = 0; writeOk && i < lines.size(); ++i)
+			writeOk = std::fprintf(out, "%s\n", lines[i].c_str()) >= 0;
+		writeOk = out && std::fclose(out) == 0 && writeOk;
+		if (!writeOk) {
+			std::fprintf(stderr, "Error: cannot write %s\n", referencePath.c_str());
+			return 1;
+		}
+		std::fprintf(stderr, "Recorded %zu case(s) in %s.\n", cases.size(), referencePath.c_str());
+		return 0;
+	}
+
+	std::fprintf(stderr, "Summary: %zu/%zu passed (%zu bit-exact, %zu within tolerance), %zu failed.\n",
+		exact + tolerated, cases.size(), exact, tolerated, failed);
+	return failed > 0 ? 1 : 0;
+}
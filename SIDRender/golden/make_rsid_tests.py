@@ -0,0 +1,224 @@
+"""Build the RSID test tunes used by the golden check (reference.txt).
+
+The SID collection has no RSID tunes, so these small hand-written ones
+stand in for the kinds the scoping doc lists (LIBSIDPLAYFP_SCOPING.md):
+each exercises a part of the engine's mini-C64 that PSID playback never
+touches.
+
+  rsid-nmi-digi.sid   init returns; a CIA 2 timer NMI plays 4-bit samples
+                      through $D418 at ~8 kHz while a raster IRQ, taken
+                      through the Kernal's $0314 vector, changes the pitch
+  rsid-mainloop.sid   init never returns: a main loop polls $D012 for the
+                      melody, and a CIA 1 IRQ at 2x the frame rate (Kernal
+                      banked out, hardware vector) plays a noise hi-hat
+  rsid-multiirq.sid   four raster IRQs per frame, each setting the next
+                      compare line, with a pulse width sweep on voice 2
+
+Run with Python 3 from this directory: python make_rsid_tests.py
+"""
+
+import struct
+
+# Opcodes by mnemonic and addressing mode (only what the tunes use)
+OPCODES = {
+    ('adc', 'zp'): 0x65, ('and', 'imm'): 0x29, ('bne', 'rel'): 0xD0,
+    ('beq', 'rel'): 0xF0, ('bpl', 'rel'): 0x10, ('clc', 'imp'): 0x18,
+    ('cli', 'imp'): 0x58, ('cmp', 'imm'): 0xC9, ('cmp', 'zp'): 0xC5,
+    ('inc', 'zp'): 0xE6, ('inx', 'imp'): 0xE8, ('jmp', 'abs'): 0x4C,
+    ('lda', 'imm'): 0xA9, ('lda', 'zp'): 0xA5, ('lda', 'abs'): 0xAD,
+    ('lda', 'abx'): 0xBD, ('ldx', 'imm'): 0xA2, ('lsr', 'imp'): 0x4A,
+    ('ora', 'imm'): 0x09, ('pha', 'imp'): 0x48, ('pla', 'imp'): 0x68,
+    ('rti', 'imp'): 0x40, ('rts', 'imp'): 0x60, ('sei', 'imp'): 0x78,
+    ('sta', 'zp'): 0x85, ('sta', 'abs'): 0x8D, ('tax', 'imp'): 0xAA,
+}
+
+
+def assemble(origin, program):
+    """Assemble (mnemonic, operand) pairs, 'label:' strings and byte lists.
+
+    Operands: None, '#n' immediate, a number (zero page below $100), a
+    label, or a number/label followed by ',x'.
+    """
+    def operand_mode(mnemonic, operand):
+        if operand is None:
+            return 'imp'
+        if isinstance(operand, str) and operand.startswith('#'):
+            return 'imm'
+        if mnemonic in ('bne', 'beq', 'bpl'):
+            return 'rel'
+        if isinstance(operand, str) and operand.endswith(',x'):
+            return 'abx'
+        if isinstance(operand, int) and operand < 0x100 and (mnemonic, 'zp') in OPCODES:
+            return 'zp'
+        return 'abs'
+
+    def size(item):
+        if isinstance(item, list):
+            return len(item)
+        mnemonic, operand = item
+        return {'imp': 1, 'imm': 2, 'zp': 2, 'rel': 2}.get(operand_mode(mnemonic, operand), 3)
+
+    labels, pc = {}, origin
+    for item in program:
+        if isinstance(item, str):
+            labels[item.rstrip(':')] = pc
+        else:
+            pc += size(item)
+
+    def value(operand):
+        operand = operand.split(',')[0] if isinstance(operand, str) else operand
+        if isinstance(operand, str):
+            if operand.startswith('#<'):
+                return labels[operand[2:]] & 0xFF
+            if operand.startswith('#>'):
+                return labels[operand[2:]] >> 8
+            if operand.startswith('#'):
+                return int(operand[1:].replace('$', '0x'), 0)
+            return labels[operand]
+        return operand
+
+    code, pc = bytearray(), origin
+    for item in program:
+        if isinstance(item, str):
+            continue
+        if isinstance(item, list):
+            code += bytes(item)
+            pc += len(item)
+            continue
+        mnemonic, operand = item
+        mode = operand_mode(mnemonic, operand)
+        code.append(OPCODES[(mnemonic, mode)])
+        if mode == 'rel':
+            offset = value(operand) - (pc + 2)
+            assert -128 <= offset < 128, operand
+            code.append(offset & 0xFF)
+        elif mode in ('imm', 'zp'):
+            code.append(value(operand))
+        elif mode != 'imp':
+            code += struct.pack('<H', value(operand))
+        pc += size(item)
+    return bytes(code)
+
+
+def rsid(name, title, load, code, ntsc=False):
+    """Write an RSID v2 file: 8580, PAL (or NTSC), one song, init = load."""
+    flags = 0x20 | (0x08 if ntsc else 0x04)  # 8580; PAL or NTSC
+    header = struct.pack('>4sHHHHHHHI32s32s32sHBBBB', b'RSID', 2, 0x7C, 0,
+                         load, 0, 1, 1, 0, title.encode(), b'SIDwinder tests',
+                         b'2026 SIDwinder', flags, 0, 0, 0, 0)
+    with open(name, 'wb') as f:
+        f.write(header + struct.pack('<H', load) + code)
+
+
+# Shared tables: a minor-key phrase as SID frequency high bytes, and the
+# phase steps that give the digi roughly the same pitches.
+MELODY = [0x11, 0x13, 0x16, 0x1A, 0x16, 0x13, 0x11, 0x0E]
+STEPS = [0x09, 0x0A, 0x0C, 0x0E, 0x0C, 0x0A, 0x09, 0x08]
+
+# Zero page: frame counter, digi phase and step, next raster line index
+FRAME, PHASE, STEP, SLICE = 0xF0, 0xF1, 0xF2, 0xF3
+
+NMI_DIGI = [
+    ('sei', None),
+    ('lda', '#0'), ('sta', FRAME), ('sta', PHASE),
+    ('lda', '#9'), ('sta', STEP),
+    # Voice 1: a quiet triangle under the digi
+    ('lda', '#$09'), ('sta', 0xD405), ('lda', '#$A0'), ('sta', 0xD406),
+    ('lda', '#$11'), ('sta', 0xD401), ('lda', '#$11'), ('sta', 0xD404),
+    # CIA 1 interrupts off; raster IRQ at line $30 through $0314
+    ('lda', '#$7F'), ('sta', 0xDC0D), ('lda', 0xDC0D),
+    ('lda', '#<irq'), ('sta', 0x0314), ('lda', '#>irq'), ('sta', 0x0315),
+    ('lda', '#$1B'), ('sta', 0xD011), ('lda', '#$30'), ('sta', 0xD012),
+    ('lda', '#$01'), ('sta', 0xD01A),
+    # CIA 2 timer A: NMI every 123 cycles, through $0318
+    ('lda', '#<nmi'), ('sta', 0x0318), ('lda', '#>nmi'), ('sta', 0x0319),
+    ('lda', '#122'), ('sta', 0xDD04), ('lda', '#0'), ('sta', 0xDD05),
+    ('lda', '#$81'), ('sta', 0xDD0D), ('lda', '#$11'), ('sta', 0xDD0E),
+    ('cli', None),
+    ('rts', None),
+    'nmi:',
+    ('pha', None),
+    ('lda', 0xDD0D),
+    ('lda', PHASE), ('clc', None), ('adc', STEP), ('sta', PHASE),
+    ('lsr', None), ('lsr', None), ('lsr', None), ('lsr', None),
+    ('sta', 0xD418),
+    ('pla', None),
+    ('rti', None),
+    'irq:',
+    ('lda', '#$FF'), ('sta', 0xD019),
+    ('inc', FRAME), ('lda', FRAME),
+    ('lsr', None), ('lsr', None), ('lsr', None), ('lsr', None),
+    ('and', '#7'), ('tax', None),
+    ('lda', 'steps,x'), ('sta', STEP),
+    ('lda', 'melody,x'), ('sta', 0xD401),
+    ('jmp', 0xEA81),
+    'steps:', STEPS,
+    'melody:', MELODY,
+]
+
+MAINLOOP = [
+    ('sei', None),
+    ('lda', '#$35'), ('sta', 0x01),
+    ('lda', '#0'), ('sta', FRAME),
+    ('lda', '#<irq'), ('sta', 0xFFFE), ('lda', '#>irq'), ('sta', 0xFFFF),
+    # CIA 1 timer A at half a frame
+    ('lda', '#$63'), ('sta', 0xDC04), ('lda', '#$26'), ('sta', 0xDC05),
+    ('lda', '#$81'), ('sta', 0xDC0D), ('lda', '#$11'), ('sta', 0xDC0E),
+    # Voice 1 pulse lead, voice 3 noise hi-hat
+    ('lda', '#$08'), ('sta', 0xD403), ('lda', '#$08'), ('sta', 0xD405),
+    ('lda', '#$C8'), ('sta', 0xD406), ('lda', '#$00'), ('sta', 0xD413),
+    ('lda', '#$A0'), ('sta', 0xD414), ('lda', '#$60'), ('sta', 0xD40F),
+    ('lda', '#$0F'), ('sta', 0xD418),
+    ('cli', None),
+    'loop:',
+    ('lda', 0xD012), ('cmp', '#$80'), ('bne', 'loop'),
+    ('inc', FRAME), ('lda', FRAME),
+    ('lsr', None), ('lsr', None), ('lsr', None),
+    ('and', '#7'), ('tax', None),
+    ('lda', 'melody,x'), ('sta', 0xD401),
+    ('lda', FRAME), ('and', '#7'), ('bne', 'hold'),
+    ('lda', '#$40'), ('sta', 0xD404),
+    ('lda', '#$41'), ('sta', 0xD404),
+    'hold:',
+    ('lda', 0xD012), ('cmp', '#$80'), ('beq', 'hold'),
+    ('jmp', 'loop'),
+    'irq:',
+    ('pha', None),
+    ('lda', 0xDC0D),
+    ('lda', '#$80'), ('sta', 0xD412),
+    ('lda', '#$81'), ('sta', 0xD412),
+    ('pla', None),
+    ('rti', None),
+    'melody:', MELODY,
+]
+
+MULTI_IRQ = [
+    ('sei', None),
+    ('lda', '#0'), ('sta', FRAME), ('sta', SLICE),
+    ('lda', '#$7F'), ('sta', 0xDC0D), ('lda', 0xDC0D),
+    ('lda', '#<irq'), ('sta', 0x0314), ('lda', '#>irq'), ('sta', 0x0315),
+    ('lda', '#$1B'), ('sta', 0xD011), ('lda', 'lines'), ('sta', 0xD012),
+    ('lda', '#$01'), ('sta', 0xD01A),
+    ('lda', '#$0A'), ('sta', 0xD40C), ('lda', '#$A9'), ('sta', 0xD40D),
+    ('lda', '#$0C'), ('sta', 0xD408), ('lda', '#$08'), ('sta', 0xD40A),
+    ('lda', '#$41'), ('sta', 0xD40B),
+    ('lda', '#$0F'), ('sta', 0xD418),
+    ('cli', None),
+    ('rts', None),
+    'irq:',
+    ('lda', '#$01'), ('sta', 0xD019),
+    ('inc', FRAME), ('lda', FRAME), ('sta', 0xD409),   # pulse width sweep, four steps a frame
+    ('lsr', None), ('lsr', None), ('lsr', None), ('lsr', None), ('lsr', None),
+    ('and', '#7'), ('tax', None),
+    ('lda', 'melody,x'), ('sta', 0xD408),
+    ('inc', SLICE), ('lda', SLICE), ('and', '#3'), ('tax', None),
+    ('lda', 'lines,x'), ('sta', 0xD012),
+    ('jmp', 0xEA81),
+    'lines:', [0x20, 0x60, 0xA0, 0xE0],
+    'melody:', MELODY,
+]
+
+if __name__ == '__main__':
+    rsid('rsid-nmi-digi.sid', 'NMI digi + raster IRQ', 0x1000, assemble(0x1000, NMI_DIGI))
+    rsid('rsid-mainloop.sid', 'Main loop + CIA IRQ', 0x1000, assemble(0x1000, MAINLOOP))
+    rsid('rsid-multiirq.sid', 'Four raster IRQs per frame', 0x1000, assemble(0x1000, MULTI_IRQ), ntsc=True)
@@ -0,0 +1,322 @@
+// SIDRender: render SID tunes to WAV files faster than real time, using the
+// same reSID playback engine as the browser (wasm/sid_audio.cpp built
+// natively). Several tunes render in parallel, one engine per thread.
+//
+//   sidrender [options] <file.sid>...
+//
+// Each <name>.sid is written to <name>.wav (in --out-dir if given, otherwise
+// next to the input), or with --dump to a <name>.sidd register dump. Inputs
+// may be register dumps too. Per-file timing and the overall speed are
+// reported on stderr.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Engine exports (wasm/sid_audio.cpp)
+extern "C" {
+	void audio_init(double sampleRate);
+	int audio_load_sid(const uint8_t* data, int length);
+	void audio_set_subtune(int subtune);
+	void audio_set_model(int model);
+	void audio_set_sampling_method(int method);
+	int audio_get_default_subtune();
+	int audio_get_subtune_count();
+	double audio_render_begin(double seconds, int format, double fadeSeconds);
+	int audio_render(uint8_t* out, int capacity);
+	int audio_dump_capture(double maxSeconds);
+	const uint8_t* audio_dump_data();
+	void audio_cleanup();
+}
+
+namespace {
+
+	struct RenderOptions {
+		std::string outDir;
+		double seconds = 180.0;
+		double fadeSeconds = 3.0;
+		int subtune = 0;          // 1-based; 0 = the tune's start song
+		int format = 1;           // 0 = 16-bit mono, 1 = 16-bit stereo, 2 = float stereo
+		int method = 2;           // 0 = fast, 1 = interpolate, 2 = resample
+		int model = 0;            // 6581/8580; 0 = from the header
+		double sampleRate = 48000.0;
+		bool dump = false;        // write a register dump instead of a WAV
+	};
+
+	struct RenderResult {
+		bool ok = false;
+		std::string message;
+		double seconds = 0.0;     // wall time
+	};
+
+	std::mutex g_printMutex;
+
+	void PrintUsage(const char* exe) {
+		std::fprintf(stderr,
+			"Usage: %s [options] <file.sid>...\n"
+			"\n"
+			"Options:\n"
+			"  -o, --out-dir <dir>    Write WAVs here (default: next to each .sid).\n"
+			"  -t, --seconds <n>      Length to render (default 180).\n"
+			"  -s, --subtune <n>      Subtune, 1-based (default: the tune's start song).\n"
+			"  --fade <n>             Fade out over the last n seconds (default 3, 0 = none).\n"
+			"  --format <f>           stereo (16-bit, default), mono (16-bit) or float (32-bit stereo).\n"
+			"  --method <m>           resample (default), interpolate or fast.\n"
+			"  --model <6581|8580>    Override the SID model from the header.\n"
+			"  --rate <hz>            Sample rate (default 48000).\n"
+			"  -j, --jobs <n>         Tunes rendered in parallel (default: CPU count).\n"
+			"  --dump                 Write a register dump (.sidd) instead, up to --seconds\n"
+			"                         long or where the tune loops.\n",
+			exe);
+	}
+
+	bool ReadFile(const std::string& path, std::vector<uint8_t>& data) {
+		FILE* f = std::fopen(path.c_str(), "rb");
+		if (!f)
+			return false;
+		std::fseek(f, 0, SEEK_END);
+		long size = std::ftell(f);
+		std::fseek(f, 0, SEEK_SET);
+		data.resize(size > 0 ? (size_t)size : 0);
+		bool ok = size > 0 && std::fread(data.data(), 1, data.size(), f) == data.size();
+		std::fclose(f);
+		return ok;
+	}
+
+	std::string OutputPath(const std::string& input, const std::string& outDir, const char* extension) {
+		std::string name = input;
+		size_t slash = name.find_last_of("/\\");
+		std::string dir = slash == std::string::npos ? std::string() : name.substr(0, slash + 1);
+		if (slash != std::string::npos)
+			name = name.substr(slash + 1);
+		size_t dot = name.find_last_of('.');
+		if (dot != std::string::npos)
+			name = name.substr(0, dot);
+
+		if (!outDir.empty()) {
+			dir = outDir;
+			if (dir.back() != '/' && dir.back() != '\\')
+				dir += '/';
+		}
+		return dir + name + extension;
+	}
+
+	// RenderFile with --dump: record the loaded subtune and write it out.
+	RenderResult DumpFile(const std::string& input, const RenderOptions& options, RenderResult& result,
+		std::chrono::steady_clock::time_point start) {
+		int size = audio_dump_capture(options.seconds);
+		if (size < 0) {
+			result.message = size == -2 ? "no play routine to record" : "cannot record a register dump";
+			audio_cleanup();
+			return result;
+		}
+
+		std::string outPath = OutputPath(input, options.outDir, ".sidd");
+		FILE* out = std::fopen(outPath.c_str(), "wb");
+		bool writeOk = out && std::fwrite(audio_dump_data(), 1, (size_t)size, out) == (size_t)size;
+		writeOk = out && std::fclose(out) == 0 && writeOk;
+		audio_cleanup();
+
+		if (!writeOk) {
+			result.message = "cannot write " + outPath;
+			return result;
+		}
+		result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		result.ok = true;
+		result.message = outPath;
+		return result;
+	}
+
+	// Runs on a worker thread; the engine state is thread-local.
+	RenderResult RenderFile(const std::string& input, const RenderOptions& options) {
+		RenderResult result;
+		auto start = std::chrono::steady_clock::now();
+
+		std::vector<uint8_t> data;
+		if (!ReadFile(input, data)) {
+			result.message = "cannot read file";
+			return result;
+		}
+
+		audio_init(options.sampleRate);
+		int rc = audio_load_sid(data.data(), (int)data.size());
+		if (rc != 0) {
+			result.message = "not a valid SID file (error " + std::to_string(rc) + ")";
+			return result;
+		}
+		if (options.model != 0)
+			audio_set_model(options.model);
+		audio_set_sampling_method(options.method);
+
+		int subtune = options.subtune > 0 ? options.subtune : audio_get_default_subtune();
+		if (subtune < 1 || subtune > audio_get_subtune_count()) {
+			result.message = "no subtune " + std::to_string(subtune);
+			audio_cleanup();
+			return result;
+		}
+		audio_set_subtune(subtune - 1);
+
+		if (options.dump)
+			return DumpFile(input, options, result, start);
+
+		if (audio_render_begin(options.seconds, options.format, options.fadeSeconds) < 0) {
+			result.message = "bad render length";
+			audio_cleanup();
+			return result;
+		}
+
+		std::string outPath = OutputPath(input, options.outDir, ".wav");
+		FILE* out = std::fopen(outPath.c_str(), "wb");
+		if (!out) {
+			result.message = "cannot write " + outPath;
+			audio_cleanup();
+			return result;
+		}
+
+		std::vector<uint8_t> chunk(1 << 16);
+		bool writeOk = true;
+		int n;
+		while ((n = audio_render(chunk.data(), (int)chunk.size())) > 0) {
+			if (std::fwrite(chunk.data(), 1, (size_t)n, out) != (size_t)n) {
+				writeOk = false;
+				break;
+			}
+		}
+		writeOk = std::fclose(out) == 0 && writeOk;
+		audio_cleanup();
+
+		if (!writeOk) {
+			result.message = "write failed: " + outPath;
+			return result;
+		}
+
+		result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		result.ok = true;
+		result.message = outPath;
+		return result;
+	}
+
+	bool ParseNumber(const char* text, double& value) {
+		char* end = nullptr;
+		value = std::strtod(text, &end);
+		return end != text && *end == 0;
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	RenderOptions options;
+	int jobs = (int)std::thread::hardware_concurrency();
+	std::vector<std::string> inputs;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--help" || arg == "-h") {
+			PrintUsage(argv[0]);
+			return 0;
+		}
+		if (arg == "--dump") {
+			options.dump = true;
+			continue;
+		}
+		if (arg.size() > 1 && arg[0] == '-') {
+			if (i + 1 >= argc) {
+				std::fprintf(stderr, "Error: %s needs an argument.\n", arg.c_str());
+				return 1;
+			}
+			const char* value = argv[++i];
+			double number = 0.0;
+			bool numeric = ParseNumber(value, number);
+
+			if (arg == "-o" || arg == "--out-dir")
+				options.outDir = value;
+			else if ((arg == "-t" || arg == "--seconds") && numeric && number > 0)
+				options.seconds = number;
+			else if ((arg == "-s" || arg == "--subtune") && numeric && number >= 1)
+				options.subtune = (int)number;
+			else if (arg == "--fade" && numeric && number >= 0)
+				options.fadeSeconds = number;
+			else if ((arg == "-j" || arg == "--jobs") && numeric && number >= 1)
+				jobs = (int)number;
+			else if (arg == "--rate" && numeric && number >= 8000 && number <= 192000)
+				options.sampleRate = number;
+			else if (arg == "--model" && numeric && (number == 6581 || number == 8580))
+				options.model = (int)number;
+			else if (arg == "--format" && std::strcmp(value, "mono") == 0)
+				options.format = 0;
+			else if (arg == "--format" && std::strcmp(value, "stereo") == 0)
+				options.format = 1;
+			else if (arg == "--format" && std::strcmp(value, "float") == 0)
+				options.format = 2;
+			else if (arg == "--method" && std::strcmp(value, "fast") == 0)
+				options.method = 0;
+			else if (arg == "--method" && std::strcmp(value, "interpolate") == 0)
+				options.method = 1;
+			else if (arg == "--method" && std::strcmp(value, "resample") == 0)
+				options.method = 2;
+			else {
+				std::fprintf(stderr, "Error: bad option %s %s\n", arg.c_str(), value);
+				return 1;
+			}
+		}
+		else
+			inputs.push_back(arg);
+	}
+
+	if (inputs.empty()) {
+		PrintUsage(argv[0]);
+		return 1;
+	}
+	jobs = std::max(1, std::min(jobs, (int)inputs.size()));
+
+	// reSID's waveform and envelope generators fill their shared tables,
+	// unlocked, in their first constructor; run that here, before any worker
+	// thread constructs its own engine. The filter's gain tables are built
+	// per chip model on first use, under a lock, so workers may do that.
+	audio_init(options.sampleRate);
+
+	std::fprintf(stderr, "Rendering %zu tune(s), %.0f s each, on %d thread(s)...\n",
+		inputs.size(), options.seconds, jobs);
+
+	auto start = std::chrono::steady_clock::now();
+	std::atomic<size_t> next{ 0 };
+	std::atomic<int> failures{ 0 };
+
+	auto worker = [&]() {
+		for (size_t i = next++; i < inputs.size(); i = next++) {
+			RenderResult result = RenderFile(inputs[i], options);
+			std::lock_guard<std::mutex> lock(g_printMutex);
+			if (result.ok) {
+				std::fprintf(stderr, "[%zu/%zu] %s -> %s (%.2fs, %.0fx real time)\n",
+					i + 1, inputs.size(), inputs[i].c_str(), result.message.c_str(),
+					result.seconds, options.seconds / std::max(result.seconds, 1e-6));
+			}
+			else {
+				std::fprintf(stderr, "[%zu/%zu] %s: %s\n",
+					i + 1, inputs.size(), inputs[i].c_str(), result.message.c_str());
+				++failures;
+			}
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (int t = 1; t < jobs; ++t)
+		threads.emplace_back(worker);
+	worker();
+	for (std::thread& t : threads)
+		t.join();
+
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	size_t rendered = inputs.size() - (size_t)failures.load();
+	std::fprintf(stderr, "\nSummary: %zu/%zu rendered in %.2fs (%.0fx real time overall).\n",
+		rendered, inputs.size(), elapsed, rendered * options.seconds / std::max(elapsed, 1e-6));
+	return failures > 0 ? 1 : 0;
+}
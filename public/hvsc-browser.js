@@ -217,6 +217,17 @@ window.hvscBrowser = (function () {
         const container = document.getElementById('hvscPlayerContainer');
         if (container && typeof SIDPlayer !== 'undefined') {
             hvscPlayer = new SIDPlayer(container);
+            // Don't play a finished tune's silence forever: go on to the
+            // next subtune, or stop after the last. While silent, reSID
+            // isn't clocked.
+            getSharedSIDPlayback().setSilenceDetection(5, true);
+            hvscPlayer.setEndedCallback((player) => {
+                if (player.currentSubtune < player.totalSubtunes - 1) {
+                    player.nextSubtune();
+                } else {
+                    player.stop();
+                }
+            });
         }
     }
 
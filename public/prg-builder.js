@@ -205,6 +205,57 @@ class SIDwinderPRGExporter {
         return 0x0900;
     }
 
+    // Parse a visualizer's reservedZeroPage list: numbers, "0xFB", or
+    // inclusive ranges such as "0xF0-0xFF".
+    parseZeroPageList(list) {
+        const result = new Set();
+        for (const entry of list || []) {
+            const [startText, endText] = String(entry).split('-');
+            const start = parseInt(startText);
+            const end = endText !== undefined ? parseInt(endText) : start;
+            for (let zp = start; zp <= end && zp <= 0xFF; zp++) {
+                result.add(zp);
+            }
+        }
+        return [...result];
+    }
+
+    // Move the tune's zero-page use off bytes the visualizer reserves by
+    // patching operands in sidInfo.data. Returns the zero-page remap table.
+    relocateZeroPage(vizConfig, sidInfo) {
+        const identity = Array.from({ length: 256 }, (_, zp) => zp);
+        const reserved = this.parseZeroPageList(vizConfig?.reservedZeroPage);
+        if (reserved.length === 0 || !this.analyzer.analysisResults) {
+            return identity;
+        }
+
+        const solution = this.analyzer.solveZeroPage(reserved);
+        if (!solution.resolved) {
+            throw new Error('Could not move the tune\'s zero page usage clear of the visualizer');
+        }
+        if (solution.unverifiedPatches > 0) {
+            console.warn(`Zero page move patched ${solution.unverifiedPatches} operands in code the analysis never ran`);
+        }
+
+        for (const patch of solution.patches) {
+            const offset = patch.address - sidInfo.loadAddress;
+            if (offset < 0 || offset >= sidInfo.data.length) {
+                throw new Error(`Zero page patch outside SID data at $${patch.address.toString(16)}`);
+            }
+            sidInfo.data[offset] = patch.value;
+        }
+
+        return solution.remap;
+    }
+
+    // Addresses the save/restore routines must cover. Prefers the liveness-
+    // based set (play writes that a later play call reads back) and falls
+    // back to every modified address for results without it.
+    getSaveRestoreAddresses(analysisResults) {
+        if (!analysisResults) return [];
+        return Array.from(analysisResults.liveAddresses || analysisResults.modifiedAddresses || []);
+    }
+
     calculateSaveRestoreSize(modifiedAddresses) {
         const filtered = modifiedAddresses.filter(addr => {
             if (addr >= 0x0100 && addr <= 0x01FF) return false;
@@ -232,9 +283,27 @@ class SIDwinderPRGExporter {
         };
     }
 
+    // True if every address in [start, end] lies inside one of the inclusive ranges.
+    isRangeCovered(ranges, start, end) {
+        let next = start;
+        for (const range of ranges || []) {
+            if (range.start > next) break;
+            if (range.end >= next) next = range.end + 1;
+            if (next > end) return true;
+        }
+        return next > end;
+    }
+
     selectValidLayouts(vizConfig, sidLoadAddress, sidSize, modifiedAddresses = null) {
         const validLayouts = [];
 
+        // Parts of the tune's load range that the analysis never saw touched
+        // may be overlaid by the visualizer. Init-only memory cannot: every
+        // player re-runs SIDInit on song change.
+        const reclaimRanges = this.analyzer?.analysisResults?.reclaimRanges;
+        const sidLoadMatches = this.analyzer?.sidHeader?.loadAddress === undefined ||
+            this.analyzer.sidHeader.loadAddress === sidLoadAddress;
+
         // The SID data range - save/restore routines are placed separately in free memory
         let effectiveSidStart = sidLoadAddress;
         let effectiveSidEnd = sidLoadAddress + sidSize;
@@ -251,7 +320,20 @@ class SIDwinderPRGExporter {
             const vizEnd = vizStart + parseInt(layout.size || '0x4000');
 
             // Check for overlaps - visualizer vs SID data range (without save/restore)
-            const hasOverlap = !(vizEnd <= effectiveSidStart || vizStart >= effectiveSidEnd);
+            let hasOverlap = !(vizEnd <= effectiveSidStart || vizStart >= effectiveSidEnd);
+            let reclaimed = false;
+            let initOnlyOverlap = false;
+
+            if (hasOverlap && reclaimRanges && sidLoadMatches) {
+                const overlapStart = Math.max(vizStart, effectiveSidStart);
+                const overlapEnd = Math.min(vizEnd, effectiveSidEnd) - 1;
+                if (this.isRangeCovered(reclaimRanges.neverUsed, overlapStart, overlapEnd)) {
+                    hasOverlap = false;
+                    reclaimed = true;
+                } else if (this.isRangeCovered(reclaimRanges.deadAfterInit, overlapStart, overlapEnd)) {
+                    initOnlyOverlap = true;
+                }
+            }
 
             const sidStartHex = '$' + effectiveSidStart.toString(16).toUpperCase().padStart(4, '0');
             const sidEndHex = '$' + effectiveSidEnd.toString(16).toUpperCase().padStart(4, '0');
@@ -267,12 +349,14 @@ class SIDwinderPRGExporter {
                 key: key,
                 layout: layout,
                 valid: !hasOverlap,
+                reclaimed: reclaimed,
                 vizStart: vizStart,
                 vizEnd: vizEnd,
                 saveRestoreStart: saveRestoreStart,
                 saveRestoreEnd: saveRestoreStart + (modifiedAddresses ? this.calculateSaveRestoreSize(modifiedAddresses).totalSize : 0),
                 overlapReason: hasOverlap ?
-                    `Overlaps with SID (${sidStartHex}-${sidEndHex})` :
+                    `Overlaps with SID (${sidStartHex}-${sidEndHex})` +
+                    (initOnlyOverlap ? ' - overlapped SID memory is only used by init, which re-runs on song change' : '') :
                     null
             });
         }
@@ -1306,7 +1390,8 @@ class SIDwinderPRGExporter {
             compressionType = 'tscrunch',
             maxCallsPerFrame = null,
             visualizerId = null,
-            selectedSong = 0
+            selectedSong = 0,
+            relocateAddress = null
         } = options;
 
         try {
@@ -1343,13 +1428,46 @@ class SIDwinderPRGExporter {
             const vizConfig = await config.loadConfig(visualizerName);
             const configMaxCallsPerFrame = vizConfig?.maxCallsPerFrame || null;
 
-            // Get modified addresses count for layout validation
-            const modifiedCount = this.analyzer.analysisResults?.modifiedAddresses?.length || 0;
+            // Optionally move the tune to a new load address first. The zero
+            // page patches below are addressed in the original layout, so
+            // sidInfo keeps its original load address until they are applied.
+            let relocation = null;
+            if (relocateAddress != null && relocateAddress !== sidInfo.loadAddress) {
+                relocation = this.analyzer.relocateSID(relocateAddress);
+                if (relocation.unverifiedOperands > 0) {
+                    console.warn(`Relocation found ${relocation.unverifiedOperands} operands in code the verification never ran`);
+                }
+                sidInfo.data = relocation.data;
+                sidInfo.dataSize = relocation.data.length;
+            }
+
+            // Keep the tune's zero page clear of bytes the visualizer needs
+            const zpRemap = this.relocateZeroPage(vizConfig, sidInfo);
+
+            const originalSidStart = sidInfo.loadAddress;
+            const originalSidEnd = originalSidStart + sidInfo.data.length;
+            const relocationDelta = relocation ? relocation.loadAddress - originalSidStart : 0;
+            if (relocation) {
+                sidInfo.loadAddress = relocation.loadAddress;
+            }
+            const analysisResults = this.analyzer.analysisResults && {
+                ...this.analyzer.analysisResults,
+                zpAddresses: (this.analyzer.analysisResults.zpAddresses || []).map(zp => zpRemap[zp])
+            };
+
+            // Get the save/restore address set for layout validation
+            const saveRestoreAddresses = this.getSaveRestoreAddresses(this.analyzer.analysisResults)
+                .map(addr => {
+                    if (addr < 0x100) return zpRemap[addr];
+                    if (addr >= originalSidStart && addr < originalSidEnd) return addr + relocationDelta;
+                    return addr;
+                });
+            const modifiedCount = saveRestoreAddresses.length;
 
             // Get the layout key from options (passed from UI) or select first valid one
             let layoutKey = options.layoutKey;
             if (!layoutKey) {
-                const validLayouts = this.selectValidLayouts(vizConfig, sidInfo.loadAddress, sidInfo.dataSize, modifiedAddresses);
+                const validLayouts = this.selectValidLayouts(vizConfig, sidInfo.loadAddress, sidInfo.dataSize, saveRestoreAddresses);
                 const firstValid = validLayouts.find(l => l.valid);
                 if (!firstValid) {
                     throw new Error(`No valid layout found for visualizer ${visualizerName}`);
@@ -1366,12 +1484,33 @@ class SIDwinderPRGExporter {
             const dataLoadAddress = parseInt(layout.dataAddress);
             const visualizerLoadAddress = parseInt(layout.sysAddress);
 
-            const actualSidAddress = (sidLoadAddress != null) ? sidLoadAddress : sidInfo.loadAddress;
-            const actualInitAddress = (sidInitAddress != null) ? sidInitAddress : actualSidAddress;
-            const actualPlayAddress = (sidPlayAddress != null) ? sidPlayAddress : (actualSidAddress + 3);
+            let actualSidAddress = (sidLoadAddress != null) ? sidLoadAddress : sidInfo.loadAddress;
+            let actualInitAddress = (sidInitAddress != null) ? sidInitAddress : actualSidAddress;
+            let actualPlayAddress = (sidPlayAddress != null) ? sidPlayAddress : (actualSidAddress + 3);
+            if (relocation) {
+                actualSidAddress = relocation.loadAddress;
+                actualInitAddress = relocation.initAddress;
+                actualPlayAddress = relocation.playAddress;
+            }
 
-            // Add SID music
-            this.builder.addComponent(sidInfo.data, actualSidAddress, 'SID Music');
+            // Add SID music. A layout may overlay never-used parts of the
+            // tune (see selectValidLayouts); leave those bytes out so the
+            // visualizer's data is not overwritten.
+            const layoutCheck = this.selectValidLayouts(vizConfig, actualSidAddress, sidInfo.dataSize)
+                .find(l => l.key === layoutKey);
+            const vizStart = parseInt(layout.baseAddress);
+            const vizEnd = vizStart + parseInt(layout.size || '0x4000');
+            const sidEnd = actualSidAddress + sidInfo.data.length;
+            if (!layoutCheck?.reclaimed || vizEnd <= actualSidAddress || vizStart >= sidEnd) {
+                this.builder.addComponent(sidInfo.data, actualSidAddress, 'SID Music');
+            } else {
+                if (vizStart > actualSidAddress) {
+                    this.builder.addComponent(sidInfo.data.slice(0, vizStart - actualSidAddress), actualSidAddress, 'SID Music');
+                }
+                if (vizEnd < sidEnd) {
+                    this.builder.addComponent(sidInfo.data.slice(vizEnd - actualSidAddress), vizEnd, 'SID Music (after visualizer)');
+                }
+            }
 
             // Add visualizer
             let nextAvailableAddress = visualizerLoadAddress;
@@ -1413,7 +1552,7 @@ class SIDwinderPRGExporter {
             let restoreRoutineAddr = 0;
 
             if (needsSaveRestore && this.analyzer.analysisResults && this.analyzer.analysisResults.modifiedAddresses) {
-                const modifiedAddrs = Array.from(this.analyzer.analysisResults.modifiedAddresses);
+                const modifiedAddrs = saveRestoreAddresses;
 
                 // Calculate the routine size FIRST to know how much space we need
                 const routineSizes = this.calculateSaveRestoreSize(modifiedAddrs);
@@ -1442,7 +1581,10 @@ class SIDwinderPRGExporter {
             // When needsSaveRestore is false, we don't add any components - the data block
             // will contain RTS instructions directly at the save/restore entry points
 
-            const numCallsPerFrame = this.analyzer.analysisResults?.numCallsPerFrame || 1;
+            // Multi-speed rate of the song being exported, which may differ
+            // from the default song's when the tune sets its timer per subtune
+            const songSpeed = this.analyzer.analysisResults?.songSpeeds?.[selectedSong];
+            const numCallsPerFrame = songSpeed?.numCallsPerFrame || this.analyzer.analysisResults?.numCallsPerFrame || 1;
             const sidChipCount = this.analyzer.analysisResults?.sidChipCount || 1;
 
             // The data block contains JMPs to save/restore routines, or RTS if not needed
@@ -1453,7 +1595,7 @@ class SIDwinderPRGExporter {
                     loadAddress: actualSidAddress,
                     dataSize: sidInfo.dataSize
                 },
-                this.analyzer.analysisResults,
+                analysisResults,
                 header,
                 saveRoutineAddr,
                 restoreRoutineAddr,
@@ -1,5 +1,44 @@
 // sid-playback.js - reSID-based SID playback engine for SIDwinder
 // Wraps reSID (via WASM) with AudioWorkletNode for glitch-free output.
+//
+// Rendering normally runs in sid-render-worker.js, which feeds the worklet
+// directly (SharedArrayBuffer ring on cross-origin isolated pages, otherwise
+// a MessagePort between the two), so main-thread work can't starve the
+// audio. If the worker can't start, the engine runs on the main thread and
+// renders whenever the worklet asks for samples.
+
+// Ring layout - keep in sync with sid-render-worker.js and sid-worklet-processor.js
+const SID_RING_WRITE = 0;
+const SID_RING_READ = 1;
+const SID_RING_DISCARD = 2;
+const SID_RING_UNDERRUNS = 4;
+const SID_RING_UNDERRUN_FRAMES = 5;
+const SID_RING_SAMPLING_METHOD = 6;
+const SID_RING_RENDER_LOAD = 7;     // per mille
+const SID_RING_CONTROL_WORDS = 8;
+const SID_RING_PLAY_TIME_OFFSET = 32;
+const SID_RING_END_OFFSET = 40;     // Float64 x 2: end status bits, silent time
+const SID_RING_DATA_OFFSET = 64;
+const SID_RING_FRAMES = 16384;
+
+// Voice taps cover 3 voices on each of up to this many chips
+const SID_MAX_CHIPS = 3;
+
+// Register stream record size (audio_set_register_stream)
+const SID_REGISTER_FRAME_BYTES = SID_MAX_CHIPS * 32;
+
+// audio_get_end_status bits
+const SID_END_SILENT = 1;
+const SID_END_GATES_OFF = 2;
+const SID_END_VOLUME_ZERO = 4;
+const SID_END_SKIPPING = 8;
+
+// audio_get_stats fields, in order - keep in sync with sid-render-worker.js
+const SID_ENGINE_STATS_FIELDS = Object.freeze([
+    'emulatedCycles', 'samples', 'blocks', 'playCalls', 'playCyclesAvg', 'playCyclesMax',
+    'guardTrips', 'guardCycles', 'stallTrips', 'cpuMs', 'sidMs', 'blockCpuMs', 'blockSidMs',
+    'blockSamples'
+]);
 
 class SIDPlayback {
     constructor(bufferSize = 4096) {
@@ -12,8 +51,51 @@ class SIDPlayback {
         this.loaded = false;
         this.playing = false;
         this.volume = 1.0;
-        this.wasmBuffer = null;
-        this.wasmBufferPtr = 0;
+        this.wasmLeftPtr = 0;
+        this.wasmRightPtr = 0;
+        this._initPromise = null;
+
+        // Render worker (null when rendering on the main thread)
+        this.renderWorker = null;
+        this._ringControl = null;
+        this._ringPlayTime = null;
+        this._ringEnd = null;
+        this._workerRequests = new Map();
+        this._nextRequestId = 1;
+
+        // Latest counters reported by the worklet or render worker
+        this._status = { playTime: 0, underruns: 0, underrunFrames: 0, bufferedFrames: 0 };
+
+        // Float32Array pairs the worklet has finished with and handed back,
+        // reused so steady-state playback allocates nothing per block.
+        this._bufferPool = [];
+
+        // Seconds of seek index built on the main-thread engine (-1 = done)
+        this._seekIndexed = -1;
+
+        // Per-voice output (setVoiceTapCallback); the buffer is main-thread only
+        this._voiceTapCallback = null;
+        this._voiceTapDecimation = 0;
+        this._voiceTapPtr = 0;
+        this._voiceTapCapacity = 0;
+
+        // Per-frame SID registers (setRegisterCallback); buffers main-thread only
+        this._registerCallback = null;
+        this._registerPtr = 0;
+        this._registerSamplePtr = 0;
+        this._registerCapacity = 0;
+
+        // Step sampling quality down while rendering can't keep up
+        this._qualityGovernor = true;
+
+        // End-of-tune detection (setSilenceDetection)
+        this._silenceSeconds = 0;
+        this._silenceSkip = false;
+
+        // Playback position in output frames (getPlaybackFrame)
+        this._renderedFrames = 0;
+        this._ringReadLast = 0;
+        this._ringReadTotal = 0;
 
         // Metadata cache (avoid crossing WASM boundary every frame)
         this._title = '';
@@ -33,42 +115,38 @@ class SIDPlayback {
         this._loadCallback = null;
     }
 
-    async init() {
-        if (this.module) return;
-
-        // Reuse the SIDwinder WASM module if already loaded by SIDAnalyzer
-        if (window.SIDwinderModule && typeof window.SIDwinderModule.cwrap === 'function') {
-            // Module already instantiated by sidwinder-core.js
-            this.module = window.SIDwinderModule;
-        } else if (typeof SIDwinderModule === 'function') {
-            // Module factory not yet called - instantiate it
-            this.module = await SIDwinderModule();
-        } else {
-            throw new Error('SIDwinderModule not loaded. Include sidwinder.js first.');
+    init() {
+        if (!this._initPromise) {
+            this._initPromise = this._init().catch((e) => {
+                this._initPromise = null;
+                throw e;
+            });
         }
+        return this._initPromise;
+    }
 
-        this._bindAPI();
-
+    async _init() {
         // Create audio context
         const AC = window.AudioContext || window.webkitAudioContext;
         this.audioCtx = new AC();
 
-        // Init the WASM audio engine with the browser's sample rate
-        this.api.audio_init(this.audioCtx.sampleRate);
-
-        // Allocate a persistent WASM buffer for audio samples (int16)
-        this.wasmBufferPtr = this.module._malloc(this.bufferSize * 2);
-
         // Register AudioWorklet processor and create node
         await this.audioCtx.audioWorklet.addModule('sid-worklet-processor.js');
-        this.workletNode = new AudioWorkletNode(this.audioCtx, 'sid-worklet-processor');
-
-        // Generate samples when the worklet needs more
-        this.workletNode.port.onmessage = (e) => {
-            if (e.data.type === 'need-samples' && this.playing && this.loaded) {
-                this._generateAndPost();
+        this.workletNode = new AudioWorkletNode(this.audioCtx, 'sid-worklet-processor', {
+            outputChannelCount: [2]
+        });
+
+        if (typeof Worker !== 'undefined') {
+            try {
+                await this._initRenderWorker();
+            } catch (e) {
+                console.warn('SID render worker unavailable, rendering on the main thread:', e);
+                this._closeRenderWorker();
             }
-        };
+        }
+        if (!this.renderWorker) {
+            await this._initMainThreadEngine();
+        }
 
         // Gain node for volume control
         this.gainNode = this.audioCtx.createGain();
@@ -82,6 +160,153 @@ class SIDPlayback {
         this.analyser.fftSize = 2048;
         this.analyser.smoothingTimeConstant = 0.6;
         this.gainNode.connect(this.analyser);
+
+        this._applyVoiceTaps();
+        this._applyRegisterStream();
+        this.api.audio_set_quality_governor(this._qualityGovernor ? 1 : 0);
+        this.api.audio_set_silence_detection(this._silenceSeconds, this._silenceSkip ? 1 : 0);
+    }
+
+    async _initRenderWorker() {
+        const worker = new Worker('sid-render-worker.js');
+        this.renderWorker = worker;
+        worker.onmessage = (e) => this._onWorkerMessage(e.data);
+        worker.onerror = (e) => {
+            e.preventDefault();
+            this._failWorkerRequests(new Error(e.message || 'SID render worker failed'));
+        };
+
+        const msg = {
+            type: 'init',
+            sampleRate: this.audioCtx.sampleRate,
+            blockFrames: this.bufferSize,
+            targetFrames: this.bufferSize * 2
+        };
+        const transfer = [];
+        let ring = null;
+        let channel = null;
+
+        if (typeof SharedArrayBuffer !== 'undefined' && self.crossOriginIsolated) {
+            ring = new SharedArrayBuffer(SID_RING_DATA_OFFSET + SID_RING_FRAMES * 8);
+            msg.ring = ring;
+        } else {
+            // Blocks go from the worker to the worklet without touching this thread
+            channel = new MessageChannel();
+            msg.port = channel.port1;
+            transfer.push(channel.port1);
+        }
+
+        await this._workerRequest(msg, transfer);
+
+        if (ring) {
+            this._ringControl = new Int32Array(ring, 0, SID_RING_CONTROL_WORDS);
+            this._ringPlayTime = new Float64Array(ring, SID_RING_PLAY_TIME_OFFSET, 1);
+            this._ringEnd = new Float64Array(ring, SID_RING_END_OFFSET, 2);
+            this.workletNode.port.postMessage({ type: 'ring', ring });
+        } else {
+            this.workletNode.port.postMessage({ type: 'connect', port: channel.port2 }, [channel.port2]);
+        }
+
+        // Setters are forwarded; nothing here needs a synchronous reply
+        const call = (op) => (...args) => worker.postMessage({ type: 'call', op, args });
+        this.api = {
+            audio_set_subtune:       call('audio_set_subtune'),
+            audio_set_chip_pan:      call('audio_set_chip_pan'),
+            audio_set_chip_gain:     call('audio_set_chip_gain'),
+            audio_set_model:         call('audio_set_model'),
+            audio_set_sampling_method: call('audio_set_sampling_method'),
+            audio_seek:              call('audio_seek'),
+            audio_set_quality_governor: call('audio_set_quality_governor'),
+            audio_set_silence_detection: call('audio_set_silence_detection'),
+            audio_get_play_time:     () => this._ringPlayTime ? this._ringPlayTime[0] : this._status.playTime,
+            audio_get_end_status:    () => this._ringEnd ? this._ringEnd[0] : (this._status.endStatus || 0),
+            audio_get_silent_time:   () => this._ringEnd ? this._ringEnd[1] : (this._status.silentTime || 0),
+            audio_cleanup:           call('audio_cleanup'),
+        };
+    }
+
+    _closeRenderWorker() {
+        if (this.renderWorker) {
+            this.renderWorker.terminate();
+            this.renderWorker = null;
+        }
+        this._ringControl = null;
+        this._ringPlayTime = null;
+        this._ringEnd = null;
+        this.api = null;
+    }
+
+    _workerRequest(msg, transfer = []) {
+        return new Promise((resolve, reject) => {
+            const id = this._nextRequestId++;
+            this._workerRequests.set(id, { resolve, reject });
+            this.renderWorker.postMessage({ ...msg, id }, transfer);
+        });
+    }
+
+    _failWorkerRequests(err) {
+        for (const pending of this._workerRequests.values()) {
+            pending.reject(err);
+        }
+        this._workerRequests.clear();
+    }
+
+    _onWorkerMessage(msg) {
+        if (msg.type === 'reply') {
+            const pending = this._workerRequests.get(msg.id);
+            if (!pending) return;
+            this._workerRequests.delete(msg.id);
+            if (msg.error) {
+                pending.reject(new Error(msg.error));
+            } else {
+                pending.resolve(msg);
+            }
+        } else if (msg.type === 'status') {
+            msg.reportTime = this.audioCtx.currentTime;
+            this._status = msg;
+        } else if (msg.type === 'voices') {
+            if (this._voiceTapCallback) this._voiceTapCallback(msg);
+        } else if (msg.type === 'registers') {
+            if (this._registerCallback) this._registerCallback(msg);
+        }
+    }
+
+    async _initMainThreadEngine() {
+        // Reuse the SIDwinder WASM module if already loaded by SIDAnalyzer
+        if (window.SIDwinderModule && typeof window.SIDwinderModule.cwrap === 'function') {
+            // Module already instantiated by sidwinder-core.js
+            this.module = window.SIDwinderModule;
+        } else if (typeof SIDwinderModule === 'function') {
+            // Module factory not yet called - instantiate it
+            this.module = await SIDwinderModule();
+        } else {
+            throw new Error('SIDwinderModule not loaded. Include sidwinder.js first.');
+        }
+
+        this._bindAPI();
+
+        // Init the WASM audio engine with the browser's sample rate
+        this.api.audio_init(this.audioCtx.sampleRate);
+
+        // Allocate persistent WASM buffers for planar float32 stereo output
+        this.wasmLeftPtr = this.module._malloc(this.bufferSize * 4);
+        this.wasmRightPtr = this.module._malloc(this.bufferSize * 4);
+
+        // Generate samples when the worklet needs more; take back spent buffers
+        this.workletNode.port.onmessage = (e) => {
+            if (e.data.type === 'need-samples') {
+                this._status.underruns = e.data.underruns;
+                this._status.underrunFrames = e.data.underrunFrames;
+                this._status.bufferedFrames = e.data.bufferedFrames;
+                this._status.renderedFrames = this._renderedFrames;
+                this._status.reportTime = this.audioCtx.currentTime;
+                if (this.playing && this.loaded) {
+                    this._generateAndPost();
+                }
+            } else if (e.data.type === 'recycle') {
+                this._bufferPool.push(e.data);
+            }
+        };
     }
 
     /** AnalyserNode tapping the playback signal (or null before init). */
@@ -89,13 +314,22 @@ class SIDPlayback {
 
     _bindAPI() {
         const cwrap = this.module.cwrap;
-        this.api = {
+        const api = {
             audio_init:              cwrap('audio_init', null, ['number']),
             audio_load_sid:          cwrap('audio_load_sid', 'number', ['number', 'number']),
             audio_set_subtune:       cwrap('audio_set_subtune', null, ['number']),
             audio_generate:          cwrap('audio_generate', 'number', ['number', 'number']),
+            audio_generate_f32:      cwrap('audio_generate_f32', 'number', ['number', 'number', 'number']),
+            audio_set_chip_pan:      cwrap('audio_set_chip_pan', null, ['number', 'number']),
+            audio_set_chip_gain:     cwrap('audio_set_chip_gain', null, ['number', 'number']),
             audio_set_model:         cwrap('audio_set_model', null, ['number']),
             audio_set_sampling_method: cwrap('audio_set_sampling_method', null, ['number']),
+            audio_set_quality_governor: cwrap('audio_set_quality_governor', null, ['number']),
+            audio_get_sampling_method: cwrap('audio_get_sampling_method', 'number', []),
+            audio_get_render_load:   cwrap('audio_get_render_load', 'number', []),
+            audio_set_silence_detection: cwrap('audio_set_silence_detection', null, ['number', 'number']),
+            audio_get_end_status:    cwrap('audio_get_end_status', 'number', []),
+            audio_get_silent_time:   cwrap('audio_get_silent_time', 'number', []),
             audio_get_title:         cwrap('audio_get_title', 'string', []),
             audio_get_author:        cwrap('audio_get_author', 'string', []),
             audio_get_copyright:     cwrap('audio_get_copyright', 'string', []),
@@ -105,32 +339,206 @@ class SIDPlayback {
             audio_get_sid_count:     cwrap('audio_get_sid_count', 'number', []),
             audio_get_play_time:     cwrap('audio_get_play_time', 'number', []),
             audio_get_is_ntsc:       cwrap('audio_get_is_ntsc', 'number', []),
+            audio_seek:              cwrap('audio_seek', 'number', ['number']),
+            audio_seek_prepare:      cwrap('audio_seek_prepare', 'number', ['number', 'number']),
+            audio_set_voice_taps:    cwrap('audio_set_voice_taps', null, ['number', 'number', 'number']),
+            audio_get_voice_tap_count: cwrap('audio_get_voice_tap_count', 'number', []),
+            audio_set_register_stream: cwrap('audio_set_register_stream', null, ['number', 'number', 'number']),
+            audio_get_register_frame_count: cwrap('audio_get_register_frame_count', 'number', []),
+            audio_dump_capture:      cwrap('audio_dump_capture', 'number', ['number']),
+            audio_dump_data:         cwrap('audio_dump_data', 'number', []),
+            audio_get_stats:         cwrap('audio_get_stats', 'number', ['number', 'number']),
             audio_cleanup:           cwrap('audio_cleanup', null, []),
         };
+
+        // The module may be shared (SIDAnalyzer, other players), so this
+        // player renders with its own engine instance and selects it first
+        const select = cwrap('audio_select', 'number', ['number']);
+        const handle = cwrap('audio_create', 'number', ['number'])(this.audioCtx.sampleRate);
+        for (const name of Object.keys(api)) {
+            const fn = api[name];
+            api[name] = (...args) => {
+                select(handle);
+                return fn(...args);
+            };
+        }
+        this.api = api;
     }
 
     _generateAndPost() {
-        const generated = this.api.audio_generate(this.wasmBufferPtr, this.bufferSize);
+        const time = this._voiceTapPtr ? this.api.audio_get_play_time() : 0;
+        const generated = this.api.audio_generate_f32(this.wasmLeftPtr, this.wasmRightPtr, this.bufferSize);
         if (generated <= 0) return;
+        this._renderedFrames += generated;
+        if (this._voiceTapPtr) this._deliverVoiceTaps(time);
+        if (this._registerPtr) this._deliverRegisters();
+        this._seekIndexStep();
 
-        // Read samples from WASM heap (use HEAPU8.buffer fresh after WASM call
+        // Read samples from WASM heap (use HEAPF32.buffer fresh after WASM call
         // to handle ALLOW_MEMORY_GROWTH buffer detachment)
-        const heap = this.module.HEAPU8.buffer;
-        const int16View = new Int16Array(heap, this.wasmBufferPtr, generated);
-
-        // Convert int16 to float32 for the worklet
-        const floatSamples = new Float32Array(generated);
-        for (let i = 0; i < generated; i++) {
-            floatSamples[i] = int16View[i] / 32768.0;
+        const heap = this.module.HEAPF32.buffer;
+
+        let block = this._bufferPool.pop();
+        if (!block || block.left.length !== this.bufferSize) {
+            block = {
+                left: new Float32Array(this.bufferSize),
+                right: new Float32Array(this.bufferSize)
+            };
         }
+        block.left.set(new Float32Array(heap, this.wasmLeftPtr, generated));
+        block.right.set(new Float32Array(heap, this.wasmRightPtr, generated));
 
-        // Transfer the buffer to the worklet (zero-copy)
+        // Transfer the buffers to the worklet (zero-copy); it sends them back
+        // as 'recycle' once played
         this.workletNode.port.postMessage(
-            { type: 'samples', samples: floatSamples },
-            [floatSamples.buffer]
+            { type: 'samples', left: block.left, right: block.right, length: generated },
+            [block.left.buffer, block.right.buffer]
         );
     }
 
+    // Build the seek index a slice at a time (the render worker does the
+    // same between its renders)
+    _seekIndexStep() {
+        if (this._seekIndexed < 0) return;
+        const indexed = this.api.audio_seek_prepare(600, 5);
+        this._seekIndexed = (indexed >= 600 || indexed <= this._seekIndexed) ? -1 : indexed;
+    }
+
+    /**
+     * Per-voice output for oscilloscope views, rendered in the same pass as
+     * the audio. Every `decimation` output frames the pre-filter output of
+     * each voice is sampled; after each rendered block `fn` gets
+     * { time, decimation, chips, count, data }, where `data` holds one plane
+     * of `count` values (about -1..1) per voice, chip 0 voices 1-3 first, and
+     * `time` is the play time at the start of the block. Blocks are rendered
+     * ahead of playback, so compare `time` with getPlayTime() to line them up
+     * with what is being heard. Pass null to turn the taps off.
+     */
+    setVoiceTapCallback(fn, decimation = 32) {
+        this._voiceTapCallback = fn || null;
+        this._voiceTapDecimation = fn ? Math.max(1, Math.floor(decimation)) : 0;
+        if (this.api) this._applyVoiceTaps();
+    }
+
+    _applyVoiceTaps() {
+        const decimation = this._voiceTapDecimation;
+        if (this.renderWorker) {
+            this.renderWorker.postMessage({ type: 'voice-taps', decimation });
+            return;
+        }
+        if (this._voiceTapPtr) {
+            this.api.audio_set_voice_taps(0, 0, 1);
+            this.module._free(this._voiceTapPtr);
+            this._voiceTapPtr = 0;
+        }
+        if (!decimation) return;
+        this._voiceTapCapacity = Math.ceil(this.bufferSize / decimation);
+        this._voiceTapPtr = this.module._malloc(SID_MAX_CHIPS * 3 * this._voiceTapCapacity * 4);
+        this.api.audio_set_voice_taps(this._voiceTapPtr, this._voiceTapCapacity, decimation);
+    }
+
+    _deliverVoiceTaps(time) {
+        const count = this.api.audio_get_voice_tap_count();
+        if (count === 0 || !this._voiceTapCallback) return;
+        const chips = this._sidCount;
+        const heap = this.module.HEAPF32;
+        const data = new Float32Array(chips * 3 * count);
+        for (let lane = 0; lane < chips * 3; lane++) {
+            const src = (this._voiceTapPtr >> 2) + lane * this._voiceTapCapacity;
+            data.set(heap.subarray(src, src + count), lane * count);
+        }
+        this._voiceTapCallback({ time, decimation: this._voiceTapDecimation, chips, count, data });
+    }
+
+    /**
+     * Per-frame SID registers, for meters and note displays driven by the
+     * audio clock instead of an FFT. After each rendered block `fn` gets
+     * { chips, count, samples, regs }: for each play frame, `samples[i]` is
+     * the output frame it starts at (compare with getPlaybackFrame()) and
+     * `regs` holds 96 bytes, 32 per chip - registers $00-$18 as the play
+     * routine set them and, at $1D-$1F, the envelope levels of voices 1-3.
+     * Pass null to turn the stream off.
+     */
+    setRegisterCallback(fn) {
+        this._registerCallback = fn || null;
+        if (this.api) this._applyRegisterStream();
+    }
+
+    _applyRegisterStream() {
+        const enabled = !!this._registerCallback;
+        if (this.renderWorker) {
+            this.renderWorker.postMessage({ type: 'register-stream', enabled });
+            return;
+        }
+        if (this._registerPtr) {
+            this.api.audio_set_register_stream(0, 0, 0);
+            this.module._free(this._registerPtr);
+            this.module._free(this._registerSamplePtr);
+            this._registerPtr = this._registerSamplePtr = 0;
+        }
+        if (!enabled) return;
+        // Room for a play call per millisecond of the block
+        this._registerCapacity = Math.ceil(this.bufferSize * 1000 / this.audioCtx.sampleRate) + 2;
+        this._registerPtr = this.module._malloc(this._registerCapacity * SID_REGISTER_FRAME_BYTES);
+        this._registerSamplePtr = this.module._malloc(this._registerCapacity * 8);
+        this.api.audio_set_register_stream(this._registerPtr, this._registerSamplePtr, this._registerCapacity);
+    }
+
+    _deliverRegisters() {
+        const count = this.api.audio_get_register_frame_count();
+        if (count === 0 || !this._registerCallback) return;
+        const first = this._registerSamplePtr >> 3;
+        const samples = this.module.HEAPF64.slice(first, first + count);
+        const regs = this.module.HEAPU8.slice(this._registerPtr, this._registerPtr + count * SID_REGISTER_FRAME_BYTES);
+        this._registerCallback({ chips: this._sidCount, count, samples, regs });
+    }
+
+    /**
+     * Output frame being heard now, on the same count as the `samples` tags
+     * of setRegisterCallback: frames the worklet has consumed, less the
+     * audio context's own output latency.
+     */
+    getPlaybackFrame() {
+        const ctx = this.audioCtx;
+        if (!ctx) return 0;
+        let played;
+        if (this._ringControl) {
+            // Ring positions are the engine's frame count, mod 2^32
+            let read = Atomics.load(this._ringControl, SID_RING_READ);
+            const discard = Atomics.load(this._ringControl, SID_RING_DISCARD);
+            if (((discard - read) | 0) > 0) read = discard;
+            this._ringReadTotal += (read - this._ringReadLast) | 0;
+            this._ringReadLast = read;
+            played = this._ringReadTotal;
+        } else {
+            // Rendered less still queued at the last report, plus time since
+            const { renderedFrames = 0, bufferedFrames = 0, reportTime } = this._status;
+            played = renderedFrames - bufferedFrames;
+            if (this.playing && reportTime !== undefined) {
+                played = Math.min(renderedFrames, played + Math.round((ctx.currentTime - reportTime) * ctx.sampleRate));
+            }
+        }
+        const latency = Math.round(((ctx.baseLatency || 0) + (ctx.outputLatency || 0)) * ctx.sampleRate);
+        return Math.max(0, played - latency);
+    }
+
+    /**
+     * Stereo position of one SID chip: -1 = left, 0 = centre, 1 = right.
+     * Loading a tune resets chips to a default spread (2SID left/right,
+     * 3SID left/centre/right).
+     */
+    setChipPan(chip, pan) {
+        if (this.api) {
+            this.api.audio_set_chip_pan(chip, pan);
+        }
+    }
+
+    setChipGain(chip, gain) {
+        if (this.api) {
+            this.api.audio_set_chip_gain(chip, gain);
+        }
+    }
+
     async loadFromArrayBuffer(arrayBuffer) {
         await this.init();
 
@@ -140,6 +548,10 @@ class SIDPlayback {
             this.workletNode.port.postMessage({ type: 'stop' });
         }
 
+        if (this.renderWorker) {
+            return this._loadInWorker(arrayBuffer);
+        }
+
         // Reset WASM SID state if a tune was already loaded
         if (this.loaded) {
             this.api.audio_cleanup();
@@ -180,6 +592,36 @@ class SIDPlayback {
         }
     }
 
+    async _loadInWorker(arrayBuffer) {
+        this.loaded = false;
+
+        // The worker gets its own copy; the caller keeps arrayBuffer
+        const copy = arrayBuffer.slice(0);
+        const reply = await this._workerRequest({ type: 'load', data: copy }, [copy]);
+        if (reply.result !== 0) {
+            throw new Error(`Failed to load SID file (error ${reply.result})`);
+        }
+
+        this._parseSIDHeader(new Uint8Array(arrayBuffer));
+
+        const info = reply.info;
+        this._title = info.title;
+        this._author = info.author;
+        this._copyright = info.copyright;
+        this._subtunes = info.subtunes;
+        this._startSong = info.startSong;
+        this._sidModel = info.sidModel;
+        this._sidCount = info.sidCount;
+        this._isNTSC = info.isNTSC;
+        this._status.playTime = 0;
+
+        this.loaded = true;
+
+        if (this._loadCallback) {
+            this._loadCallback();
+        }
+    }
+
     async loadFromUrl(url) {
         const response = await fetch(url);
         if (!response.ok) throw new Error(`Failed to fetch ${url}: ${response.status}`);
@@ -190,6 +632,44 @@ class SIDPlayback {
     setSubtune(subtune) {
         if (!this.loaded) return;
         this.api.audio_set_subtune(subtune);
+        this._seekIndexed = 0;
+    }
+
+    /**
+     * Record the current subtune as a register dump: its SID writes, frame
+     * by frame, up to where the tune loops or maxSeconds (0 = the engine's
+     * default of 10 minutes). Resolves to a Uint8Array that loadFromArrayBuffer()
+     * plays without running the tune's code. The subtune restarts.
+     */
+    async captureDump(maxSeconds = 0) {
+        if (!this.loaded) return null;
+        let result, data;
+        if (this.renderWorker) {
+            ({ result, data } = await this._workerRequest({ type: 'dump', maxSeconds }));
+        } else {
+            result = this.api.audio_dump_capture(maxSeconds);
+            if (result >= 0) {
+                const ptr = this.api.audio_dump_data();
+                data = this.module.HEAPU8.slice(ptr, ptr + result);
+            }
+        }
+        this._seekIndexed = 0;
+        if (result < 0) throw new Error(`Failed to capture register dump (error ${result})`);
+        return data;
+    }
+
+    /**
+     * Jump to `seconds` into the current subtune. The engine restores its
+     * nearest snapshot and fast-forwards without rendering audio, so this
+     * takes milliseconds even far into a long tune.
+     */
+    seek(seconds) {
+        if (!this.loaded) return;
+        this.api.audio_seek(seconds);
+        if (this.playing) {
+            // Drop audio rendered before the seek and refill from the new spot
+            this.play();
+        }
     }
 
     play() {
@@ -206,9 +686,14 @@ class SIDPlayback {
         this.workletNode.port.postMessage({ type: 'stop' });
         this.workletNode.port.postMessage({ type: 'start' });
 
-        // Pre-fill the worklet queue so playback starts immediately
-        for (let i = 0; i < 3; i++) {
-            this._generateAndPost();
+        if (this.renderWorker) {
+            // The worker flushes anything rendered earlier and refills
+            this.renderWorker.postMessage({ type: 'start' });
+        } else {
+            // Pre-fill the worklet queue so playback starts immediately
+            for (let i = 0; i < 3; i++) {
+                this._generateAndPost();
+            }
         }
 
         // Fade in from silence to mask any transition click (~85ms)
@@ -228,6 +713,9 @@ class SIDPlayback {
         if (this.workletNode) {
             this.workletNode.port.postMessage({ type: 'stop' });
         }
+        if (this.renderWorker) {
+            this.renderWorker.postMessage({ type: 'stop' });
+        }
         try {
             (this.analyser || this.gainNode).disconnect(this.audioCtx.destination);
         } catch (e) {
@@ -265,12 +753,60 @@ class SIDPlayback {
         }
     }
 
+    /**
+     * Quality governor (on by default): while rendering takes too much of
+     * the real-time budget, the engine steps the sampling method down
+     * (resample -> interpolate -> fast) and later back up, never above the
+     * method set with setSamplingMethod(). getStats() reports where it is.
+     */
+    setQualityGovernor(enabled) {
+        this._qualityGovernor = !!enabled;
+        if (this.api) {
+            this.api.audio_set_quality_governor(this._qualityGovernor ? 1 : 0);
+        }
+    }
+
+    /**
+     * End-of-tune detection: output that stays quiet for `seconds` (0 = the
+     * engine's default of 5) is reported as silent by getEndStatus(). With
+     * skipIdle, the engine stops clocking reSID while the tune is silent
+     * and every voice is idle, holding the output level, which saves the
+     * CPU a finished tune would keep using; a new note wakes it.
+     */
+    setSilenceDetection(seconds = 0, skipIdle = false) {
+        this._silenceSeconds = seconds;
+        this._silenceSkip = !!skipIdle;
+        if (this.api) {
+            this.api.audio_set_silence_detection(this._silenceSeconds, this._silenceSkip ? 1 : 0);
+        }
+    }
+
+    /**
+     * Whether the tune looks finished, as of the last rendered block: silent
+     * (quiet for the setSilenceDetection() timeout) and for how long in
+     * seconds, whether every voice is released (gatesOff) and the volume is
+     * zero, and whether reSID is idle-skipped. Cheap enough to poll with the
+     * play time; a playlist would move on once `silent` is set.
+     */
+    getEndStatus() {
+        const status = this.api && this.loaded ? this.api.audio_get_end_status() : 0;
+        return {
+            silent: (status & SID_END_SILENT) !== 0,
+            silentTime: this.api && this.loaded ? this.api.audio_get_silent_time() : 0,
+            gatesOff: (status & SID_END_GATES_OFF) !== 0,
+            volumeZero: (status & SID_END_VOLUME_ZERO) !== 0,
+            idle: (status & SID_END_SKIPPING) !== 0
+        };
+    }
+
     setLoadCallback(fn) {
         this._loadCallback = fn;
     }
 
     _parseSIDHeader(data) {
         if (data.length < 0x76) return;
+        const magic = String.fromCharCode(data[0], data[1], data[2], data[3]);
+        if (magic !== 'PSID' && magic !== 'RSID') return;  // a register dump
         const be16 = (hi, lo) => (data[hi] << 8) | data[lo];
         const dataOffset = be16(0x06, 0x07);
         let loadAddr = be16(0x08, 0x09);
@@ -306,14 +842,99 @@ class SIDPlayback {
         return Math.floor(this.api.audio_get_play_time());
     }
 
+    /**
+     * Playback health: where rendering runs ('ring', 'port' or 'main'),
+     * underruns (audio callbacks that ran out of samples mid-playback) and
+     * the frames they were short by, the current output latency
+     * (buffered audio plus the context's own latency), the sampling method
+     * in effect (see setQualityGovernor) and the render headroom (share of
+     * real time not spent rendering).
+     */
+    getStats() {
+        let { underruns, underrunFrames, bufferedFrames, samplingMethod, renderLoad } = this._status;
+        let renderer = 'main';
+
+        if (this._ringControl) {
+            const ctl = this._ringControl;
+            let read = Atomics.load(ctl, SID_RING_READ);
+            const discard = Atomics.load(ctl, SID_RING_DISCARD);
+            if (((discard - read) | 0) > 0) read = discard;
+            bufferedFrames = (Atomics.load(ctl, SID_RING_WRITE) - read) | 0;
+            underruns = Atomics.load(ctl, SID_RING_UNDERRUNS);
+            underrunFrames = Atomics.load(ctl, SID_RING_UNDERRUN_FRAMES);
+            samplingMethod = Atomics.load(ctl, SID_RING_SAMPLING_METHOD);
+            renderLoad = Atomics.load(ctl, SID_RING_RENDER_LOAD) / 1000;
+            renderer = 'ring';
+        } else if (this.renderWorker) {
+            renderer = 'port';
+        } else if (this.api) {
+            samplingMethod = this.api.audio_get_sampling_method();
+            renderLoad = this.api.audio_get_render_load();
+        }
+
+        const ctx = this.audioCtx;
+        const contextLatency = ctx ? (ctx.baseLatency || 0) + (ctx.outputLatency || 0) : 0;
+        const sampleRate = ctx ? ctx.sampleRate : 44100;
+
+        return {
+            renderer,
+            underruns,
+            underrunFrames,
+            bufferedFrames,
+            latencyMs: (bufferedFrames / sampleRate + contextLatency) * 1000,
+            samplingMethod: samplingMethod !== undefined ? samplingMethod : 1,
+            renderHeadroom: 1 - (renderLoad || 0)
+        };
+    }
+
+    /**
+     * Emulation cost counters from the engine, since it started or the last
+     * reset: cycles emulated and samples rendered, play calls and their
+     * average/maximum cycles, play calls cut off by the cycle limit
+     * (guardTrips, and the cycles they ran), render loop stalls, and render
+     * time split between the 6510 (cpuMs) and reSID (sidMs), in total and
+     * for the last render block. Resolves to an object of numbers; reset
+     * clears the counters after reading.
+     */
+    async getEngineStats(reset = false) {
+        if (this.renderWorker) {
+            const reply = await this._workerRequest({ type: 'stats', reset });
+            return reply.stats;
+        }
+        if (!this.api) return null;
+        const ptr = this.module._malloc(SID_ENGINE_STATS_FIELDS.length * 8);
+        try {
+            this.api.audio_get_stats(ptr, reset ? 1 : 0);
+            const values = this.module.HEAPF64.subarray(ptr >> 3, (ptr >> 3) + SID_ENGINE_STATS_FIELDS.length);
+            const stats = {};
+            SID_ENGINE_STATS_FIELDS.forEach((name, i) => { stats[name] = values[i]; });
+            return stats;
+        } finally {
+            this.module._free(ptr);
+        }
+    }
+
     cleanup() {
         this.pause();
         if (this.api) {
             this.api.audio_cleanup();
         }
-        if (this.wasmBufferPtr && this.module) {
-            this.module._free(this.wasmBufferPtr);
-            this.wasmBufferPtr = 0;
+        if (this.wasmLeftPtr && this.module) {
+            this.module._free(this.wasmLeftPtr);
+            this.module._free(this.wasmRightPtr);
+            this.wasmLeftPtr = 0;
+            this.wasmRightPtr = 0;
+        }
+        if (this._voiceTapPtr && this.module) {
+            this.api.audio_set_voice_taps(0, 0, 1);
+            this.module._free(this._voiceTapPtr);
+            this._voiceTapPtr = 0;
+        }
+        if (this._registerPtr && this.module) {
+            this.api.audio_set_register_stream(0, 0, 0);
+            this.module._free(this._registerPtr);
+            this.module._free(this._registerSamplePtr);
+            this._registerPtr = this._registerSamplePtr = 0;
         }
         this.loaded = false;
     }
@@ -328,3 +949,63 @@ function getSharedSIDPlayback() {
     }
     return _sharedSIDPlayback;
 }
+
+const SID_RENDER_FORMATS = { mono: 0, stereo: 1, float: 2 };
+
+/**
+ * Render a tune to a WAV Blob as fast as the emulation runs, in a one-shot
+ * worker so playback (and the page) keep going meanwhile. Memory stays
+ * bounded in the worker; the file arrives in chunks.
+ *
+ * options: subtune (0-based, default the start song), seconds (180),
+ * fadeSeconds (3), format ('stereo', 'mono' or 'float'), method
+ * (0 = fast, 1 = interpolate, 2 = resample, the default), model (6581/8580,
+ * default from the header), sampleRate (48000) and onProgress(done, total)
+ * in bytes.
+ */
+function renderSIDToWAV(arrayBuffer, options = {}) {
+    return new Promise((resolve, reject) => {
+        const worker = new Worker('sid-render-worker.js');
+        const chunks = [];
+        const onProgress = options.onProgress;
+        const fail = (err) => {
+            worker.terminate();
+            reject(err);
+        };
+
+        worker.onerror = (e) => {
+            e.preventDefault();
+            fail(new Error(e.message || 'SID render worker failed'));
+        };
+        worker.onmessage = (e) => {
+            const msg = e.data;
+            if (msg.type === 'render-chunk') {
+                chunks.push(msg.chunk);
+                if (onProgress) onProgress(msg.done, msg.total);
+            } else if (msg.type === 'reply' && msg.id === 1) {
+                worker.postMessage({
+                    type: 'render',
+                    id: 2,
+                    data: arrayBuffer,
+                    subtune: options.subtune,
+                    seconds: options.seconds || 180,
+                    fadeSeconds: options.fadeSeconds !== undefined ? options.fadeSeconds : 3,
+                    format: SID_RENDER_FORMATS[options.format || 'stereo'],
+                    method: options.method !== undefined ? options.method : 2,
+                    model: options.model || 0
+                });
+            } else if (msg.type === 'reply') {
+                worker.terminate();
+                if (msg.error) {
+                    reject(new Error(msg.error));
+                } else if (msg.result !== 0) {
+                    reject(new Error('SID render failed (error ' + msg.result + ')'));
+                } else {
+                    resolve(new Blob(chunks, { type: 'audio/wav' }));
+                }
+            }
+        };
+
+        worker.postMessage({ type: 'init', id: 1, sampleRate: options.sampleRate || 48000 });
+    });
+}
@@ -17,6 +17,8 @@ class SIDPlayer {
         this._lastLoadedData = null;
         this._lastLoadedFilename = null;
         this._ownershipLost = false;
+        this._endedCallback = null;
+        this._endReported = false;
         this.buildUI();
     }
 
@@ -257,8 +259,15 @@ class SIDPlayer {
         this.els.nextBtn.disabled = this.currentSubtune >= this.totalSubtunes - 1;
     }
 
+    // Called once per play when the engine reports the tune silent (see
+    // SIDPlayback.getEndStatus), e.g. to move a playlist on
+    setEndedCallback(fn) {
+        this._endedCallback = fn;
+    }
+
     startTimeUpdate() {
         this.stopTimeUpdate();
+        this._endReported = false;
         this.playTimeInterval = setInterval(() => {
             if (this.isPlaying) {
                 const player = getSharedSIDPlayback();
@@ -266,6 +275,11 @@ class SIDPlayer {
                 const mins = Math.floor(seconds / 60);
                 const secs = seconds % 60;
                 this.els.time.textContent = `${mins}:${secs.toString().padStart(2, '0')}`;
+
+                if (this._endedCallback && !this._endReported && player.getEndStatus().silent) {
+                    this._endReported = true;
+                    this._endedCallback(this);
+                }
             }
         }, 500);
     }
@@ -0,0 +1,524 @@
+// sid-render-worker.js - reSID render worker for SIDwinder playback
+// Runs its own instance of the SIDwinder WASM module so audio rendering never
+// waits on the main thread. Output goes straight to sid-worklet-processor.js,
+// either through a SharedArrayBuffer ring (no messages per block) or, when the
+// page is not cross-origin isolated, as transferred blocks over a
+// MessagePort connected directly to the worklet. The main thread only sends
+// control messages (load, start/stop, subtune, model, pan, gain). With voice
+// taps or the register stream on, what each rendered block produced is
+// posted back to the main thread as a 'voices' / 'registers' message.
+//
+// A worker started without a ring or port is a one-shot offline renderer
+// ('render'): it streams a WAV file back in chunks (see renderSIDToWAV in
+// sid-playback.js).
+
+importScripts('sidwinder.js');
+
+// Ring layout - keep in sync with sid-playback.js and sid-worklet-processor.js
+const RING_WRITE = 0;
+const RING_READ = 1;
+const RING_DISCARD = 2;
+const RING_PRODUCING = 3;
+const RING_UNDERRUNS = 4;
+const RING_UNDERRUN_FRAMES = 5;
+const RING_SAMPLING_METHOD = 6;
+const RING_RENDER_LOAD = 7;     // per mille
+const RING_CONTROL_WORDS = 8;
+const RING_PLAY_TIME_OFFSET = 32;
+const RING_END_OFFSET = 40;     // Float64 x 2: audio_get_end_status, audio_get_silent_time
+const RING_DATA_OFFSET = 64;
+const RING_FRAMES = 16384;
+const RING_MASK = RING_FRAMES - 1;
+
+// How often the ring is topped up. Well inside the buffered latency, so a
+// late timer costs headroom rather than an underrun.
+const PUMP_INTERVAL_MS = 10;
+
+// Size of each WAV chunk posted back by an offline render
+const RENDER_CHUNK_BYTES = 1 << 20;
+
+// The seek index is built this far ahead, a slice of play time after each
+// render, so a first seek anywhere in a long tune is quick too
+const SEEK_INDEX_SECONDS = 600;
+const SEEK_INDEX_SLICE_SECONDS = 5;
+
+// Voice taps: 3 voices per chip, for up to this many chips
+const MAX_SID_CHIPS = 3;
+
+// Register stream record size (audio_set_register_stream)
+const REGISTER_FRAME_BYTES = MAX_SID_CHIPS * 32;
+
+// audio_get_stats fields, in order - keep in sync with sid-playback.js
+const ENGINE_STATS_FIELDS = Object.freeze([
+    'emulatedCycles', 'samples', 'blocks', 'playCalls', 'playCyclesAvg', 'playCyclesMax',
+    'guardTrips', 'guardCycles', 'stallTrips', 'cpuMs', 'sidMs', 'blockCpuMs', 'blockSidMs',
+    'blockSamples'
+]);
+
+// Engine calls the main thread may forward as-is
+const FORWARDED_CALLS = new Set([
+    'audio_set_subtune', 'audio_set_model', 'audio_set_sampling_method',
+    'audio_set_chip_pan', 'audio_set_chip_gain', 'audio_seek', 'audio_set_quality_governor',
+    'audio_set_silence_detection', 'audio_cleanup'
+]);
+
+let module = null;
+let api = null;
+let leftPtr = 0;
+let rightPtr = 0;
+let blockFrames = 0;
+let targetFrames = 0;
+let loaded = false;
+let producing = false;
+let pumpTimer = 0;
+let seekIndexed = -1;   // seconds of seek index built; -1 = nothing left to do
+
+// Voice taps (0 = off)
+let tapPtr = 0;
+let tapCapacity = 0;
+let tapDecimation = 0;
+
+// Register stream (0 = off)
+let regPtr = 0;
+let regSamplePtr = 0;
+let regCapacity = 0;
+
+// Frames rendered since audio_init: the engine's output sample index, which
+// is also the ring position the frames were written to
+let renderedFrames = 0;
+let sampleRate = 0;
+
+// Ring transport
+let ringControl = null;
+let ringPlayTime = null;
+let ringEnd = null;
+let ringLeft = null;
+let ringRight = null;
+
+// Block transport
+let dataPort = null;
+let bufferPool = [];
+let queuedFrames = 0;
+let workletStats = { underruns: 0, underrunFrames: 0, bufferedFrames: 0 };
+
+function bindAPI() {
+    const cwrap = module.cwrap;
+    api = {
+        audio_init:              cwrap('audio_init', null, ['number']),
+        audio_load_sid:          cwrap('audio_load_sid', 'number', ['number', 'number']),
+        audio_set_subtune:       cwrap('audio_set_subtune', null, ['number']),
+        audio_generate_f32:      cwrap('audio_generate_f32', 'number', ['number', 'number', 'number']),
+        audio_set_chip_pan:      cwrap('audio_set_chip_pan', null, ['number', 'number']),
+        audio_set_chip_gain:     cwrap('audio_set_chip_gain', null, ['number', 'number']),
+        audio_set_model:         cwrap('audio_set_model', null, ['number']),
+        audio_set_sampling_method: cwrap('audio_set_sampling_method', null, ['number']),
+        audio_set_quality_governor: cwrap('audio_set_quality_governor', null, ['number']),
+        audio_get_sampling_method: cwrap('audio_get_sampling_method', 'number', []),
+        audio_get_render_load:   cwrap('audio_get_render_load', 'number', []),
+        audio_set_silence_detection: cwrap('audio_set_silence_detection', null, ['number', 'number']),
+        audio_get_end_status:    cwrap('audio_get_end_status', 'number', []),
+        audio_get_silent_time:   cwrap('audio_get_silent_time', 'number', []),
+        audio_get_title:         cwrap('audio_get_title', 'string', []),
+        audio_get_author:        cwrap('audio_get_author', 'string', []),
+        audio_get_copyright:     cwrap('audio_get_copyright', 'string', []),
+        audio_get_subtune_count: cwrap('audio_get_subtune_count', 'number', []),
+        audio_get_default_subtune: cwrap('audio_get_default_subtune', 'number', []),
+        audio_get_sid_model:     cwrap('audio_get_sid_model', 'number', []),
+        audio_get_sid_count:     cwrap('audio_get_sid_count', 'number', []),
+        audio_get_play_time:     cwrap('audio_get_play_time', 'number', []),
+        audio_get_is_ntsc:       cwrap('audio_get_is_ntsc', 'number', []),
+        audio_set_voice_taps:    cwrap('audio_set_voice_taps', null, ['number', 'number', 'number']),
+        audio_get_voice_tap_count: cwrap('audio_get_voice_tap_count', 'number', []),
+        audio_set_register_stream: cwrap('audio_set_register_stream', null, ['number', 'number', 'number']),
+        audio_get_register_frame_count: cwrap('audio_get_register_frame_count', 'number', []),
+        audio_seek:              cwrap('audio_seek', 'number', ['number']),
+        audio_seek_prepare:      cwrap('audio_seek_prepare', 'number', ['number', 'number']),
+        audio_render_begin:      cwrap('audio_render_begin', 'number', ['number', 'number', 'number']),
+        audio_render:            cwrap('audio_render', 'number', ['number', 'number']),
+        audio_dump_capture:      cwrap('audio_dump_capture', 'number', ['number']),
+        audio_dump_data:         cwrap('audio_dump_data', 'number', []),
+        audio_get_stats:         cwrap('audio_get_stats', 'number', ['number', 'number']),
+        audio_cleanup:           cwrap('audio_cleanup', null, []),
+    };
+}
+
+async function init(msg) {
+    module = await SIDwinderModule();
+    bindAPI();
+    api.audio_init(msg.sampleRate);
+    sampleRate = msg.sampleRate;
+
+    // Offline render jobs have no transport
+    if (!msg.ring && !msg.port) return;
+
+    blockFrames = msg.blockFrames;
+    leftPtr = module._malloc(blockFrames * 4);
+    rightPtr = module._malloc(blockFrames * 4);
+
+    if (msg.ring) {
+        ringControl = new Int32Array(msg.ring, 0, RING_CONTROL_WORDS);
+        ringPlayTime = new Float64Array(msg.ring, RING_PLAY_TIME_OFFSET, 1);
+        ringEnd = new Float64Array(msg.ring, RING_END_OFFSET, 2);
+        ringLeft = new Float32Array(msg.ring, RING_DATA_OFFSET, RING_FRAMES);
+        ringRight = new Float32Array(msg.ring, RING_DATA_OFFSET + RING_FRAMES * 4, RING_FRAMES);
+        // Writing more than half the ring ahead could overwrite frames the
+        // worklet is still reading after a discard
+        targetFrames = Math.min(msg.targetFrames, RING_FRAMES / 2);
+    } else {
+        dataPort = msg.port;
+        dataPort.onmessage = (e) => onWorkletMessage(e.data);
+    }
+}
+
+function onWorkletMessage(msg) {
+    if (msg.type === 'need-samples') {
+        workletStats = {
+            underruns: msg.underruns,
+            underrunFrames: msg.underrunFrames,
+            bufferedFrames: msg.bufferedFrames
+        };
+        queuedFrames = msg.bufferedFrames;
+        if (producing) {
+            postBlock();
+            postStatus();
+            indexStep();
+        }
+    } else if (msg.type === 'recycle') {
+        bufferPool.push(msg);
+    }
+}
+
+// Render one block into the WASM scratch buffers; returns frames rendered
+function render(frames) {
+    const time = tapDecimation ? api.audio_get_play_time() : 0;
+    const generated = api.audio_generate_f32(leftPtr, rightPtr, frames);
+    if (generated <= 0) return 0;
+    renderedFrames += generated;
+    if (tapDecimation) postVoices(time);
+    if (regCapacity) postRegisters();
+    return generated;
+}
+
+// Turn voice taps on (every `decimation` frames) or off (0)
+function setVoiceTaps(decimation) {
+    if (tapPtr) {
+        api.audio_set_voice_taps(0, 0, 1);
+        module._free(tapPtr);
+        tapPtr = 0;
+    }
+    tapDecimation = decimation > 0 && blockFrames > 0 ? decimation : 0;
+    if (!tapDecimation) return;
+    tapCapacity = Math.ceil(blockFrames / tapDecimation);
+    tapPtr = module._malloc(MAX_SID_CHIPS * 3 * tapCapacity * 4);
+    api.audio_set_voice_taps(tapPtr, tapCapacity, tapDecimation);
+}
+
+// Turn the register stream on or off. Sized for a play call per millisecond.
+function setRegisterStream(enabled) {
+    if (regPtr) {
+        api.audio_set_register_stream(0, 0, 0);
+        module._free(regPtr);
+        module._free(regSamplePtr);
+        regPtr = regSamplePtr = 0;
+    }
+    regCapacity = enabled && blockFrames > 0 ? Math.ceil(blockFrames * 1000 / sampleRate) + 2 : 0;
+    if (!regCapacity) return;
+    regPtr = module._malloc(regCapacity * REGISTER_FRAME_BYTES);
+    regSamplePtr = module._malloc(regCapacity * 8);
+    api.audio_set_register_stream(regPtr, regSamplePtr, regCapacity);
+}
+
+// Post the register frames of the block just rendered
+function postRegisters() {
+    const count = api.audio_get_register_frame_count();
+    if (count === 0) return;
+    const samples = module.HEAPF64.slice(regSamplePtr >> 3, (regSamplePtr >> 3) + count);
+    const regs = module.HEAPU8.slice(regPtr, regPtr + count * REGISTER_FRAME_BYTES);
+    postMessage({ type: 'registers', chips: api.audio_get_sid_count(), count, samples, regs },
+        [samples.buffer, regs.buffer]);
+}
+
+// Post the taps of the block just rendered, one plane of `count` values per
+// voice (chip 0 voices 1-3, then chip 1...). `time` is the play time at the
+// start of the block.
+function postVoices(time) {
+    const count = api.audio_get_voice_tap_count();
+    if (count === 0) return;
+    const chips = api.audio_get_sid_count();
+    const heap = module.HEAPF32;
+    const data = new Float32Array(chips * 3 * count);
+    for (let lane = 0; lane < chips * 3; lane++) {
+        const src = (tapPtr >> 2) + lane * tapCapacity;
+        data.set(heap.subarray(src, src + count), lane * count);
+    }
+    postMessage({ type: 'voices', time, decimation: tapDecimation, chips, count, data }, [data.buffer]);
+}
+
+// Extend the seek index by one slice; stops once it is complete or stuck
+function indexStep() {
+    if (seekIndexed < 0) return;
+    const indexed = api.audio_seek_prepare(SEEK_INDEX_SECONDS, SEEK_INDEX_SLICE_SECONDS);
+    seekIndexed = (indexed >= SEEK_INDEX_SECONDS || indexed <= seekIndexed) ? -1 : indexed;
+}
+
+// ---- Ring transport ----
+
+function pump() {
+    pumpTimer = 0;
+    if (!producing) return;
+
+    for (;;) {
+        const write = Atomics.load(ringControl, RING_WRITE);
+        let read = Atomics.load(ringControl, RING_READ);
+        const discard = Atomics.load(ringControl, RING_DISCARD);
+        if (((discard - read) | 0) > 0) read = discard;
+
+        const room = targetFrames - ((write - read) | 0);
+        if (room < 128) break;
+
+        const n = render(Math.min(room, blockFrames));
+        if (n === 0) break;
+
+        // Fresh heap view after the call (memory growth detaches old ones)
+        const heap = module.HEAPF32;
+        const left = leftPtr >> 2;
+        const right = rightPtr >> 2;
+        const start = write & RING_MASK;
+        const first = Math.min(n, RING_FRAMES - start);
+        ringLeft.set(heap.subarray(left, left + first), start);
+        ringRight.set(heap.subarray(right, right + first), start);
+        if (first < n) {
+            ringLeft.set(heap.subarray(left + first, left + n), 0);
+            ringRight.set(heap.subarray(right + first, right + n), 0);
+        }
+        Atomics.store(ringControl, RING_WRITE, (write + n) | 0);
+    }
+
+    ringPlayTime[0] = api.audio_get_play_time();
+    Atomics.store(ringControl, RING_SAMPLING_METHOD, api.audio_get_sampling_method());
+    Atomics.store(ringControl, RING_RENDER_LOAD, Math.round(api.audio_get_render_load() * 1000));
+    ringEnd[0] = api.audio_get_end_status();
+    ringEnd[1] = api.audio_get_silent_time();
+    indexStep();
+    pumpTimer = setTimeout(pump, PUMP_INTERVAL_MS);
+}
+
+// ---- Block transport ----
+
+function postBlock() {
+    const n = render(blockFrames);
+    if (n === 0) return;
+
+    const heap = module.HEAPF32.buffer;
+    let block = bufferPool.pop();
+    if (!block || block.left.length !== blockFrames) {
+        block = { left: new Float32Array(blockFrames), right: new Float32Array(blockFrames) };
+    }
+    block.left.set(new Float32Array(heap, leftPtr, n));
+    block.right.set(new Float32Array(heap, rightPtr, n));
+    dataPort.postMessage(
+        { type: 'samples', left: block.left, right: block.right, length: n },
+        [block.left.buffer, block.right.buffer]
+    );
+    queuedFrames += n;
+}
+
+function postStatus() {
+    postMessage({
+        type: 'status',
+        playTime: api.audio_get_play_time(),
+        underruns: workletStats.underruns,
+        underrunFrames: workletStats.underrunFrames,
+        bufferedFrames: queuedFrames,
+        renderedFrames,
+        samplingMethod: api.audio_get_sampling_method(),
+        renderLoad: api.audio_get_render_load(),
+        endStatus: api.audio_get_end_status(),
+        silentTime: api.audio_get_silent_time()
+    });
+}
+
+// ---- Control ----
+
+// Everything rendered so far is stale (new tune, subtune restart, stop)
+function discardRendered() {
+    if (ringControl) {
+        Atomics.store(ringControl, RING_DISCARD, Atomics.load(ringControl, RING_WRITE));
+    } else {
+        queuedFrames = 0;
+    }
+}
+
+function start() {
+    discardRendered();
+    producing = true;
+    if (ringControl) {
+        Atomics.store(ringControl, RING_PRODUCING, 1);
+        if (!pumpTimer) pump();
+    } else {
+        // The worklet flushed its queue on 'start'; pre-fill it
+        for (let i = 0; i < 3; i++) postBlock();
+        postStatus();
+    }
+}
+
+function stop() {
+    producing = false;
+    if (ringControl) {
+        Atomics.store(ringControl, RING_PRODUCING, 0);
+    }
+    if (pumpTimer) {
+        clearTimeout(pumpTimer);
+        pumpTimer = 0;
+    }
+    discardRendered();
+}
+
+function load(data) {
+    stop();
+    if (loaded) {
+        api.audio_cleanup();
+        loaded = false;
+    }
+
+    const ptr = module._malloc(data.length);
+    module.HEAPU8.set(data, ptr);
+    const result = api.audio_load_sid(ptr, data.length);
+    module._free(ptr);
+
+    if (result !== 0) {
+        return { result };
+    }
+    loaded = true;
+    seekIndexed = 0;
+    if (ringPlayTime) ringPlayTime[0] = 0;
+    if (ringEnd) ringEnd.fill(0);
+
+    return {
+        result,
+        info: {
+            title: api.audio_get_title(),
+            author: api.audio_get_author(),
+            copyright: api.audio_get_copyright(),
+            subtunes: api.audio_get_subtune_count(),
+            startSong: api.audio_get_default_subtune(),
+            sidModel: api.audio_get_sid_model(),
+            sidCount: api.audio_get_sid_count(),
+            isNTSC: api.audio_get_is_ntsc() !== 0
+        }
+    };
+}
+
+// Record the current subtune as a register dump (audio_dump_capture). The
+// subtune restarts, as audio_set_subtune would.
+function captureDump(maxSeconds) {
+    const size = api.audio_dump_capture(maxSeconds);
+    seekIndexed = 0;
+    if (ringPlayTime) ringPlayTime[0] = api.audio_get_play_time();
+    if (size < 0) return { result: size };
+    const ptr = api.audio_dump_data();
+    const data = module.HEAPU8.slice(ptr, ptr + size);
+    return { result: 0, data };
+}
+
+// The engine's counters (audio_get_stats) as an object, cleared after
+// reading if reset is set
+function engineStats(reset) {
+    const ptr = module._malloc(ENGINE_STATS_FIELDS.length * 8);
+    try {
+        api.audio_get_stats(ptr, reset ? 1 : 0);
+        const values = module.HEAPF64.subarray(ptr >> 3, (ptr >> 3) + ENGINE_STATS_FIELDS.length);
+        const stats = {};
+        ENGINE_STATS_FIELDS.forEach((name, i) => { stats[name] = values[i]; });
+        return stats;
+    } finally {
+        module._free(ptr);
+    }
+}
+
+// ---- Offline render ----
+
+// Render msg.seconds of a tune to WAV, posting 'render-chunk' messages as
+// it goes; the reply carries the result code and total size.
+function renderWAV(msg) {
+    const loadResult = load(new Uint8Array(msg.data));
+    if (loadResult.result !== 0) return loadResult;
+
+    if (msg.model) api.audio_set_model(msg.model);
+    api.audio_set_sampling_method(msg.method);
+    const subtune = msg.subtune !== undefined ? msg.subtune : api.audio_get_default_subtune() - 1;
+    api.audio_set_subtune(subtune);
+
+    const total = api.audio_render_begin(msg.seconds, msg.format, msg.fadeSeconds);
+    if (total < 0) return { result: total };
+
+    const ptr = module._malloc(RENDER_CHUNK_BYTES);
+    try {
+        let done = 0;
+        for (;;) {
+            const n = api.audio_render(ptr, RENDER_CHUNK_BYTES);
+            if (n <= 0) break;
+            const chunk = module.HEAPU8.slice(ptr, ptr + n);
+            done += n;
+            postMessage({ type: 'render-chunk', id: msg.id, chunk, done, total }, [chunk.buffer]);
+        }
+    } finally {
+        module._free(ptr);
+    }
+    return { result: 0, total };
+}
+
+onmessage = async (e) => {
+    const msg = e.data;
+    try {
+        switch (msg.type) {
+            case 'init':
+                await init(msg);
+                postMessage({ type: 'reply', id: msg.id });
+                break;
+            case 'load':
+                postMessage({ type: 'reply', id: msg.id, ...load(new Uint8Array(msg.data)) });
+                break;
+            case 'render':
+                postMessage({ type: 'reply', id: msg.id, ...renderWAV(msg) });
+                break;
+            case 'dump': {
+                const reply = loaded ? captureDump(msg.maxSeconds) : { result: -1 };
+                postMessage({ type: 'reply', id: msg.id, ...reply }, reply.data ? [reply.data.buffer] : []);
+                break;
+            }
+            case 'stats':
+                postMessage({ type: 'reply', id: msg.id, stats: engineStats(msg.reset) });
+                break;
+            case 'start':
+                if (loaded) start();
+                break;
+            case 'stop':
+                stop();
+                break;
+            case 'voice-taps':
+                setVoiceTaps(msg.decimation);
+                break;
+            case 'register-stream':
+                setRegisterStream(msg.enabled);
+                break;
+            case 'call':
+                if (!FORWARDED_CALLS.has(msg.op)) break;
+                if (msg.op === 'audio_cleanup') {
+                    stop();
+                    if (!loaded) break;
+                    loaded = false;
+                }
+                api[msg.op](...msg.args);
+                if (msg.op === 'audio_set_subtune') seekIndexed = 0;
+                if (ringPlayTime && loaded) ringPlayTime[0] = api.audio_get_play_time();
+                break;
+        }
+    } catch (err) {
+        if (msg.id !== undefined) {
+            postMessage({ type: 'reply', id: msg.id, error: String(err && err.message || err) });
+        } else {
+            console.error('sid-render-worker:', err);
+        }
+    }
+};
@@ -1,6 +1,27 @@
 // sid-worklet-processor.js - AudioWorklet processor for SID playback
-// Receives Float32 audio samples from the main thread via MessagePort
-// and outputs them in the audio thread's process() callback.
+// Outputs planar Float32 stereo rendered by sid_audio.cpp. Samples arrive
+// one of two ways:
+//  - ring: a SharedArrayBuffer written by sid-render-worker.js and read here
+//    without any messages (needs a cross-origin isolated page)
+//  - blocks: buffers posted over a MessagePort (to the render worker, or to
+//    the main thread as a fallback); each block's buffers are handed back
+//    ('recycle') once played.
+// Underruns (process() calls that ran out of samples mid-playback) are
+// counted in both modes.
+
+// Ring layout - keep in sync with sid-playback.js and sid-render-worker.js
+const RING_WRITE = 0;            // frames written (render worker)
+const RING_READ = 1;             // frames read (worklet)
+const RING_DISCARD = 2;          // frames before this position are stale
+const RING_PRODUCING = 3;        // 1 while the render worker is playing
+const RING_UNDERRUNS = 4;
+const RING_UNDERRUN_FRAMES = 5;
+const RING_SAMPLING_METHOD = 6;   // in effect (render worker's quality governor)
+const RING_RENDER_LOAD = 7;       // render time / audio time, per mille
+const RING_CONTROL_WORDS = 8;
+const RING_DATA_OFFSET = 64;     // bytes; play time (Float64) sits at 32, end status at 40
+const RING_FRAMES = 16384;       // power of two
+const RING_MASK = RING_FRAMES - 1;
 
 class SIDWorkletProcessor extends AudioWorkletProcessor {
     constructor() {
@@ -8,68 +29,159 @@ class SIDWorkletProcessor extends AudioWorkletProcessor {
         this._queue = [];
         this._offset = 0;
         this._active = false;
+        this._primed = false;
         this._totalSamples = 0;
         this._requested = false;
+        this._underruns = 0;
+        this._underrunFrames = 0;
+
+        this._ringControl = null;
+        this._ringLeft = null;
+        this._ringRight = null;
+
+        // Port carrying sample blocks; the render worker replaces it
+        this._dataPort = this.port;
 
         this.port.onmessage = (e) => {
             const msg = e.data;
-            if (msg.type === 'samples') {
-                this._queue.push(msg.samples);
-                this._totalSamples += msg.samples.length;
-                this._requested = false;
+            if (msg.type === 'ring') {
+                this._ringControl = new Int32Array(msg.ring, 0, RING_CONTROL_WORDS);
+                this._ringLeft = new Float32Array(msg.ring, RING_DATA_OFFSET, RING_FRAMES);
+                this._ringRight = new Float32Array(msg.ring, RING_DATA_OFFSET + RING_FRAMES * 4, RING_FRAMES);
+            } else if (msg.type === 'connect') {
+                this._dataPort = msg.port;
+                this._dataPort.onmessage = (ev) => this._onData(ev.data);
             } else if (msg.type === 'start') {
                 this._active = true;
+                this._primed = false;
                 this._requested = false;
             } else if (msg.type === 'stop') {
                 this._active = false;
-                this._queue.length = 0;
-                this._offset = 0;
-                this._totalSamples = 0;
-                this._requested = false;
+                this._flush();
+            } else {
+                this._onData(msg);
             }
         };
     }
 
+    _onData(msg) {
+        if (msg.type === 'samples') {
+            this._queue.push(msg);
+            this._totalSamples += msg.length;
+            this._requested = false;
+        }
+    }
+
+    _flush() {
+        while (this._queue.length > 0) {
+            this._recycle(this._queue.shift());
+        }
+        this._offset = 0;
+        this._totalSamples = 0;
+        this._requested = false;
+    }
+
+    _recycle(block) {
+        this._dataPort.postMessage(
+            { type: 'recycle', left: block.left, right: block.right },
+            [block.left.buffer, block.right.buffer]
+        );
+    }
+
     process(inputs, outputs) {
-        const output = outputs[0][0];
+        const outLeft = outputs[0][0];
+        // Mono output (a single-channel node) takes the left channel only
+        const outRight = outputs[0][1];
 
         if (!this._active) {
-            output.fill(0);
+            outLeft.fill(0);
+            if (outRight) outRight.fill(0);
             return true;
         }
 
+        if (this._ringControl) {
+            this._processRing(outLeft, outRight);
+        } else {
+            this._processBlocks(outLeft, outRight);
+        }
+        return true;
+    }
+
+    _processRing(outLeft, outRight) {
+        const ctl = this._ringControl;
+        let read = Atomics.load(ctl, RING_READ);
+        const discard = Atomics.load(ctl, RING_DISCARD);
+        if (((discard - read) | 0) > 0) read = discard;
+
+        const avail = (Atomics.load(ctl, RING_WRITE) - read) | 0;
+        const n = Math.min(avail, outLeft.length);
+        const start = read & RING_MASK;
+        const first = Math.min(n, RING_FRAMES - start);
+
+        outLeft.set(this._ringLeft.subarray(start, start + first));
+        if (first < n) outLeft.set(this._ringLeft.subarray(0, n - first), first);
+        if (outRight) {
+            outRight.set(this._ringRight.subarray(start, start + first));
+            if (first < n) outRight.set(this._ringRight.subarray(0, n - first), first);
+        }
+        Atomics.store(ctl, RING_READ, (read + n) | 0);
+
+        if (n < outLeft.length) {
+            outLeft.fill(0, n);
+            if (outRight) outRight.fill(0, n);
+            // An empty ring before the first samples of a start is just
+            // startup, not an underrun
+            if (this._primed && Atomics.load(ctl, RING_PRODUCING)) {
+                Atomics.add(ctl, RING_UNDERRUNS, 1);
+                Atomics.add(ctl, RING_UNDERRUN_FRAMES, outLeft.length - n);
+            }
+        }
+        if (n > 0) this._primed = true;
+    }
+
+    _processBlocks(outLeft, outRight) {
         let written = 0;
-        while (written < output.length && this._queue.length > 0) {
-            const buf = this._queue[0];
-            const avail = buf.length - this._offset;
-            const need = output.length - written;
+        while (written < outLeft.length && this._queue.length > 0) {
+            const block = this._queue[0];
+            const avail = block.length - this._offset;
+            const need = outLeft.length - written;
             const n = Math.min(avail, need);
 
-            for (let i = 0; i < n; i++) {
-                output[written + i] = buf[this._offset + i];
+            outLeft.set(block.left.subarray(this._offset, this._offset + n), written);
+            if (outRight) {
+                outRight.set(block.right.subarray(this._offset, this._offset + n), written);
             }
 
             written += n;
             this._offset += n;
             this._totalSamples -= n;
 
-            if (this._offset >= buf.length) {
-                this._queue.shift();
+            if (this._offset >= block.length) {
+                this._recycle(this._queue.shift());
                 this._offset = 0;
             }
         }
 
-        for (let i = written; i < output.length; i++) {
-            output[i] = 0;
+        if (written < outLeft.length) {
+            outLeft.fill(0, written);
+            if (outRight) outRight.fill(0, written);
+            if (this._primed) {
+                this._underruns++;
+                this._underrunFrames += outLeft.length - written;
+            }
         }
+        if (written > 0) this._primed = true;
 
         // Request more samples when buffer is running low
         if (this._totalSamples < 8192 && !this._requested) {
             this._requested = true;
-            this.port.postMessage({ type: 'need-samples' });
+            this._dataPort.postMessage({
+                type: 'need-samples',
+                underruns: this._underruns,
+                underrunFrames: this._underrunFrames,
+                bufferedFrames: this._totalSamples
+            });
         }
-
-        return true;
     }
 }
 
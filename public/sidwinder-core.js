@@ -38,8 +38,21 @@ class SIDAnalyzer {
                 sid_create_modified: this.Module.cwrap('sid_create_modified', 'number', ['number']),
                 sid_get_modified_count: this.Module.cwrap('sid_get_modified_count', 'number', []),
                 sid_get_modified_address: this.Module.cwrap('sid_get_modified_address', 'number', ['number']),
+                sid_get_live_count: this.Module.cwrap('sid_get_live_count', 'number', []),
+                sid_get_live_address: this.Module.cwrap('sid_get_live_address', 'number', ['number']),
+                sid_get_reclaim_range_count: this.Module.cwrap('sid_get_reclaim_range_count', 'number', ['number']),
+                sid_get_reclaim_range_start: this.Module.cwrap('sid_get_reclaim_range_start', 'number', ['number', 'number']),
+                sid_get_reclaim_range_end: this.Module.cwrap('sid_get_reclaim_range_end', 'number', ['number', 'number']),
                 sid_get_zp_count: this.Module.cwrap('sid_get_zp_count', 'number', []),
                 sid_get_zp_address: this.Module.cwrap('sid_get_zp_address', 'number', ['number']),
+                sid_zp_clear_reserved: this.Module.cwrap('sid_zp_clear_reserved', null, []),
+                sid_zp_reserve: this.Module.cwrap('sid_zp_reserve', null, ['number']),
+                sid_zp_solve: this.Module.cwrap('sid_zp_solve', 'number', []),
+                sid_get_zp_remap: this.Module.cwrap('sid_get_zp_remap', 'number', ['number']),
+                sid_get_zp_patch_count: this.Module.cwrap('sid_get_zp_patch_count', 'number', []),
+                sid_get_zp_patch_address: this.Module.cwrap('sid_get_zp_patch_address', 'number', ['number']),
+                sid_get_zp_patch_value: this.Module.cwrap('sid_get_zp_patch_value', 'number', ['number']),
+                sid_get_zp_unverified_count: this.Module.cwrap('sid_get_zp_unverified_count', 'number', []),
                 sid_get_code_bytes: this.Module.cwrap('sid_get_code_bytes', 'number', []),
                 sid_get_data_bytes: this.Module.cwrap('sid_get_data_bytes', 'number', []),
                 sid_get_sid_writes: this.Module.cwrap('sid_get_sid_writes', 'number', ['number']),
@@ -50,6 +63,22 @@ class SIDAnalyzer {
                 sid_get_num_calls_per_frame: this.Module.cwrap('sid_get_num_calls_per_frame', 'number', []),
                 sid_get_cia_timer_detected: this.Module.cwrap('sid_get_cia_timer_detected', 'number', []),
                 sid_get_cia_timer_value: this.Module.cwrap('sid_get_cia_timer_value', 'number', []),
+                sid_get_speed_profile: this.Module.cwrap('sid_get_speed_profile', 'number', []),
+                sid_get_song_calls_per_frame: this.Module.cwrap('sid_get_song_calls_per_frame', 'number', ['number']),
+                sid_get_song_cia_timer: this.Module.cwrap('sid_get_song_cia_timer', 'number', ['number']),
+                sid_get_song_timer_change_count: this.Module.cwrap('sid_get_song_timer_change_count', 'number', ['number']),
+                sid_get_song_timer_change_call: this.Module.cwrap('sid_get_song_timer_change_call', 'number', ['number', 'number']),
+                sid_get_song_timer_change_latch: this.Module.cwrap('sid_get_song_timer_change_latch', 'number', ['number', 'number']),
+                sid_relocate: this.Module.cwrap('sid_relocate', 'number', ['number', 'number']),
+                sid_get_relocated_data: this.Module.cwrap('sid_get_relocated_data', 'number', []),
+                sid_get_relocated_size: this.Module.cwrap('sid_get_relocated_size', 'number', []),
+                sid_get_relocated_address: this.Module.cwrap('sid_get_relocated_address', 'number', ['number']),
+                sid_get_relocation_patch_count: this.Module.cwrap('sid_get_relocation_patch_count', 'number', []),
+                sid_get_relocation_unverified_count: this.Module.cwrap('sid_get_relocation_unverified_count', 'number', []),
+                sid_get_relocation_untraced_count: this.Module.cwrap('sid_get_relocation_untraced_count', 'number', []),
+                sid_get_relocation_ambiguous_offset: this.Module.cwrap('sid_get_relocation_ambiguous_offset', 'number', []),
+                sid_get_relocation_mismatch_song: this.Module.cwrap('sid_get_relocation_mismatch_song', 'number', []),
+                sid_get_relocation_mismatch_frame: this.Module.cwrap('sid_get_relocation_mismatch_frame', 'number', []),
                 sid_get_max_cycles: this.Module.cwrap('sid_get_max_cycles', 'number', []),
                 sid_cleanup: this.Module.cwrap('sid_cleanup', null, []),
 
@@ -194,6 +223,36 @@ class SIDAnalyzer {
                 }
             }
 
+            // Play-phase live-out set: written by play and read back by a
+            // later play call. This is all an extra play call must preserve.
+            const liveAddresses = [];
+            const liveCount = this.api.sid_get_live_count();
+            for (let i = 0; i < liveCount; i++) {
+                const addr = this.api.sid_get_live_address(i);
+                if (addr !== 0xFFFF) {
+                    liveAddresses.push(addr);
+                }
+            }
+
+            // Ranges of the load range that are never touched, or not touched
+            // again after init / after the first play call (inclusive ends).
+            const readReclaimRanges = (kind) => {
+                const ranges = [];
+                const count = this.api.sid_get_reclaim_range_count(kind);
+                for (let i = 0; i < count; i++) {
+                    ranges.push({
+                        start: this.api.sid_get_reclaim_range_start(kind, i),
+                        end: this.api.sid_get_reclaim_range_end(kind, i)
+                    });
+                }
+                return ranges;
+            };
+            const reclaimRanges = {
+                neverUsed: readReclaimRanges(0),
+                deadAfterInit: readReclaimRanges(1),
+                deadAfterFrame0: readReclaimRanges(2)
+            };
+
             const zpAddresses = [];
             const zpCount = this.api.sid_get_zp_count();
             for (let i = 0; i < zpCount; i++) {
@@ -218,6 +277,27 @@ class SIDAnalyzer {
             const numCallsPerFrame = this.api.sid_get_num_calls_per_frame();
             const ciaTimerDetected = this.api.sid_get_cia_timer_detected() ? true : false;
             const ciaTimerValue = this.api.sid_get_cia_timer_value();
+
+            // Per-song play rate (0-based song index) and how it changes over
+            // play calls, plus an overall profile for choosing a player.
+            const speedProfile = ['none', 'constant', 'per-subtune', 'changing'][this.api.sid_get_speed_profile()] || 'none';
+            const songSpeeds = [];
+            const songCount = this.api.sid_get_header_value(4) || 1;
+            for (let song = 0; song < songCount; song++) {
+                const timerChanges = [];
+                const changeCount = this.api.sid_get_song_timer_change_count(song);
+                for (let i = 0; i < changeCount; i++) {
+                    timerChanges.push({
+                        playCall: this.api.sid_get_song_timer_change_call(song, i),
+                        latch: this.api.sid_get_song_timer_change_latch(song, i)
+                    });
+                }
+                songSpeeds.push({
+                    numCallsPerFrame: this.api.sid_get_song_calls_per_frame(song),
+                    ciaTimerValue: this.api.sid_get_song_cia_timer(song),
+                    timerChanges
+                });
+            }
             const maxCycles = this.api.sid_get_max_cycles();
             const sidChipCount = this.api.sid_get_sid_chip_count();
 
@@ -231,6 +311,8 @@ class SIDAnalyzer {
 
             return {
                 modifiedAddresses,
+                liveAddresses,
+                reclaimRanges,
                 zpAddresses,
                 sidWrites,
                 codeBytes: this.api.sid_get_code_bytes(),
@@ -238,6 +320,8 @@ class SIDAnalyzer {
                 numCallsPerFrame,
                 ciaTimerDetected,
                 ciaTimerValue,
+                speedProfile,
+                songSpeeds,
                 maxCycles,
                 sidChipCount,
                 sidChipAddresses
@@ -249,6 +333,103 @@ class SIDAnalyzer {
         }
     }
 
+    /**
+     * Compute a zero-page remapping that keeps the analyzed tune off the
+     * given reserved bytes. Requires analyze() to have run. Returns the
+     * remap table (remap[old] = new), the operand patches to apply to the
+     * tune's data, the number of bytes moved, whether every conflict was
+     * resolved, and how many patches are in code the analysis never ran
+     * (found by decoding, so no replay of the analysis covers them).
+     */
+    solveZeroPage(reservedAddresses) {
+        if (!this.wasmReady) {
+            throw new Error('WASM not ready');
+        }
+
+        this.api.sid_zp_clear_reserved();
+        for (const zp of reservedAddresses) {
+            this.api.sid_zp_reserve(zp & 0xFF);
+        }
+
+        const result = this.api.sid_zp_solve();
+        if (result === -1) {
+            throw new Error('No SID loaded');
+        }
+
+        const remap = [];
+        for (let zp = 0; zp < 256; zp++) {
+            remap.push(this.api.sid_get_zp_remap(zp));
+        }
+
+        const patches = [];
+        const patchCount = this.api.sid_get_zp_patch_count();
+        for (let i = 0; i < patchCount; i++) {
+            patches.push({
+                address: this.api.sid_get_zp_patch_address(i),
+                value: this.api.sid_get_zp_patch_value(i)
+            });
+        }
+
+        return {
+            remap,
+            patches,
+            movedBytes: result >= 0 ? result : remap.filter((to, from) => to !== from).length,
+            resolved: result >= 0,
+            unverifiedPatches: this.api.sid_get_zp_unverified_count()
+        };
+    }
+
+    /**
+     * Relocate the loaded tune to a new load address (same offset within
+     * the page) and verify it against the original over `frames` play
+     * calls of every song. Returns { data, loadAddress, initAddress,
+     * playAddress, patchCount, unverifiedOperands, untracedBytes }; throws
+     * with the reason on failure. unverifiedOperands were found by decoding
+     * code those calls never ran, so the check did not cover them;
+     * untracedBytes were neither decoded as code nor read as data.
+     */
+    relocateSID(newLoadAddress, frames = 1500) {
+        if (!this.wasmReady) {
+            throw new Error('WASM not ready');
+        }
+
+        const result = this.api.sid_relocate(newLoadAddress, frames);
+        if (result !== 0) {
+            const reasons = {
+                '-1': 'No SID loaded',
+                '-2': 'Relocation must move the tune by whole pages',
+                '-3': 'Target range is outside usable memory',
+                '-4': 'Tune has no play address',
+                '-6': 'Original tune does not run to completion'
+            };
+            if (result === -5) {
+                const offset = this.api.sid_get_relocation_ambiguous_offset();
+                throw new Error(`Byte at offset $${offset.toString(16).toUpperCase()} is used both as an address and as SID data`);
+            }
+            if (result === -7) {
+                const song = this.api.sid_get_relocation_mismatch_song() + 1;
+                const frame = this.api.sid_get_relocation_mismatch_frame();
+                throw new Error(`Relocated tune differs from the original (song ${song}, ${frame < 0 ? 'init' : `frame ${frame}`})`);
+            }
+            throw new Error(reasons[result] || `Relocation failed (${result})`);
+        }
+
+        const dataPtr = this.api.sid_get_relocated_data();
+        const size = this.api.sid_get_relocated_size();
+        const data = new Uint8Array(size);
+        data.set(this.Module.HEAPU8.subarray(dataPtr, dataPtr + size));
+
+        return {
+            data,
+            loadAddress: this.api.sid_get_relocated_address(1),
+            initAddress: this.api.sid_get_relocated_address(2),
+            playAddress: this.api.sid_get_relocated_address(3),
+            patchCount: this.api.sid_get_relocation_patch_count(),
+            unverifiedOperands: this.api.sid_get_relocation_unverified_count(),
+            untracedBytes: this.api.sid_get_relocation_untraced_count()
+        };
+    }
+
     /**
      * Update an editable header string (name/author/copyright).
      * SID header strings are limited to 31 characters plus a null terminator.
@@ -574,7 +574,7 @@ class UIController {
 
             this.updateZeroPageInfo(this.analysisResults.zpAddresses);
             this.updateModifiedMemoryCount();
-            this.updateNumCallsPerFrame(this.analysisResults.numCallsPerFrame);
+            this.updateNumCallsPerFrame(this.analysisResults.numCallsPerFrame, this.analysisResults.speedProfile);
             this.updateMaxCycles(this.analysisResults.maxCycles);
             this.updateSidChipCount(this.analysisResults.sidChipCount, this.analysisResults.sidChipAddresses);
 
@@ -680,7 +680,7 @@ class UIController {
         const compatible = [];
         const incompatible = [];
 
-        const modifiedAddresses = this.analysisResults?.modifiedAddresses || [];
+        const modifiedAddresses = this.prgExporter.getSaveRestoreAddresses(this.analysisResults);
 
         for (const viz of VISUALIZERS) {
             if (viz.configData) {
@@ -909,8 +909,6 @@ class UIController {
     async createLayoutSelectorHTML(visualizer, config) {
         const sidLoadAddress = this.sidHeader?.loadAddress || 0x1000;
         const sidSize = this.analysisResults?.dataBytes || 0x2000;
-        const modifiedAddresses = this.analysisResults?.modifiedAddresses || [];
-
         let sidStart = sidLoadAddress;
         let sidEnd = sidLoadAddress + sidSize - 1;
 
@@ -919,6 +917,7 @@ class UIController {
 
         await this.ensurePRGExporter();
 
+        const modifiedAddresses = this.prgExporter.getSaveRestoreAddresses(this.analysisResults);
         const layouts = this.prgExporter.selectValidLayouts(config, sidLoadAddress, sidSize, modifiedAddresses);
 
         layouts.sort((a, b) => a.vizStart - b.vizStart);
@@ -1570,7 +1569,8 @@ class UIController {
 
     // Add this new method after updateTechnicalInfo:
     updateModifiedMemoryCount() {
-        const allModified = this.analysisResults?.modifiedAddresses || [];
+        // Only the play-phase live set is saved/restored around extra play calls
+        const allModified = this.analysisResults?.liveAddresses || this.analysisResults?.modifiedAddresses || [];
 
         // Apply the same filtering as save/restore routines
         const filtered = allModified.filter(addr => {
@@ -1652,10 +1652,14 @@ class UIController {
         this.elements.zpUsage.textContent = formatted.join(', ');
     }
 
-    updateNumCallsPerFrame(numCalls) {
+    updateNumCallsPerFrame(numCalls, speedProfile = 'none') {
         const element = document.getElementById('numCallsPerFrame');
         if (element) {
-            element.textContent = numCalls || '1';
+            const notes = {
+                'per-subtune': ' (varies per subtune)',
+                'changing': ' (tune changes speed)'
+            };
+            element.textContent = `${numCalls || '1'}${notes[speedProfile] || ''}`;
         }
     }
 
@@ -20,6 +20,27 @@ extern "C" {
         MEM_OPCODE = 1 << 4
     };
 
+    // Per-phase liveness flags. A "read-in" is a read (data access or
+    // instruction fetch) of a value that was not written earlier in the same
+    // init/play call, i.e. a value carried in from a previous call.
+    enum LivenessFlag {
+        LIVE_INIT_WRITE = 1 << 0,
+        LIVE_INIT_READ_IN = 1 << 1,
+        LIVE_PLAY_WRITE = 1 << 2,
+        LIVE_PLAY_READ_IN = 1 << 3
+    };
+
+    // Per-byte zero-page flags for the ZP relocation solver.
+    enum ZeroPageFlag {
+        ZP_POINTER = 1 << 0,     // Low byte of a (zp),Y / (zp,X) / JMP ($00xx) pointer
+        ZP_UNPATCHABLE = 1 << 1  // Accessed in a way no operand patch can follow
+    };
+
+    enum ExecutionPhase {
+        PHASE_INIT = 0,
+        PHASE_PLAY = 1
+    };
+
     // CPU Status flags
     enum StatusFlag {
         FLAG_CARRY = 0x01,
@@ -46,6 +67,14 @@ extern "C" {
         uint8_t ciaTimerHi;
         bool ciaTimerWritten;
 
+        // Every CIA #1 timer A latch write, stamped with the epoch it
+        // happened in, so the effective play rate can be followed over time.
+        struct TimerWrite {
+            uint32_t epoch;
+            uint16_t latch;
+        };
+        std::vector<TimerWrite> timerWrites;
+
         uint8_t memory[65536];
         uint8_t memoryAccess[65536];
 
@@ -73,8 +102,32 @@ extern "C" {
         // Set by KIL/JAM opcodes; cpu_execute_function exits immediately when true
         bool halted;
 
+        // Optional hooks for tools layered on this CPU (the relocator): called
+        // before each instruction and on each instruction-driven write,
+        // regardless of trackingEnabled. Not reset by cpu_init.
+        void (*stepObserver)(uint16_t pc);
+        void (*writeObserver)(uint16_t address, uint8_t value);
+
         // Track cycles from last function execution
         uint32_t lastExecutionCycles;
+
+        // Liveness tracking: each init/play call is one epoch, and writeEpoch
+        // records the epoch in which each address was last written.
+        uint32_t epoch;
+        uint8_t phase;
+        uint32_t writeEpoch[65536];
+        uint8_t liveness[65536];
+
+        // Temporal use map: first and last epoch in which each address was
+        // touched (0 = never, 1 = init, 2 + N = play call N), saturating.
+        uint16_t firstUse[65536];
+        uint16_t lastUse[65536];
+
+        // Zero-page references: for each instruction whose operand names a
+        // zero-page address, the number of bytes from that address it has
+        // been seen to touch (index offset + 1, plus 1 for pointer high bytes).
+        uint16_t zpOperandSpan[65536];
+        uint8_t zpFlags[256];
     } cpu;
 
     // Helper function to read 16-bit address from memory
@@ -98,6 +151,7 @@ extern "C" {
         cpu.ciaTimerLo = 0;
         cpu.ciaTimerHi = 0;
         cpu.ciaTimerWritten = false;
+        cpu.timerWrites.clear();
 
         cpu.totalSidWrites = 0;
         cpu.totalZpWrites = 0;
@@ -105,6 +159,8 @@ extern "C" {
         cpu.trackingEnabled = false;
         cpu.halted = false;
         cpu.lastExecutionCycles = 0;
+        cpu.epoch = 0;
+        cpu.phase = PHASE_INIT;
 
         memset(cpu.memory, 0, sizeof(cpu.memory));
         memset(cpu.memoryAccess, 0, sizeof(cpu.memoryAccess));
@@ -112,6 +168,12 @@ extern "C" {
         memset(cpu.sidChipsUsed, 0, sizeof(cpu.sidChipsUsed));
         memset(cpu.zpWrites, 0, sizeof(cpu.zpWrites));
         memset(cpu.lastWritePC, 0, sizeof(cpu.lastWritePC));
+        memset(cpu.writeEpoch, 0, sizeof(cpu.writeEpoch));
+        memset(cpu.liveness, 0, sizeof(cpu.liveness));
+        memset(cpu.firstUse, 0, sizeof(cpu.firstUse));
+        memset(cpu.lastUse, 0, sizeof(cpu.lastUse));
+        memset(cpu.zpOperandSpan, 0, sizeof(cpu.zpOperandSpan));
+        memset(cpu.zpFlags, 0, sizeof(cpu.zpFlags));
 
         cpu.writeSequence.clear();
     }
@@ -145,14 +207,38 @@ extern "C" {
         cpu.memory[address] = value;
     }
 
+    // Record a read for liveness: the value is live-in to the current epoch
+    // unless this same init/play call already wrote it.
+    inline void track_read_in(uint16_t address) {
+        if (cpu.writeEpoch[address] != cpu.epoch) {
+            cpu.liveness[address] |= (cpu.phase == PHASE_PLAY) ? LIVE_PLAY_READ_IN : LIVE_INIT_READ_IN;
+        }
+    }
+
+    // Stamp the current epoch into the temporal use map.
+    inline void track_use(uint16_t address) {
+        uint16_t stamp = cpu.epoch < 0xFFFF ? uint16_t(cpu.epoch) : 0xFFFF;
+        if (cpu.firstUse[address] == 0) {
+            cpu.firstUse[address] = stamp;
+        }
+        cpu.lastUse[address] = stamp;
+    }
+
     // Instruction-driven write: this is the path that records access info.
     void write_memory_internal(uint16_t address, uint8_t value) {
         cpu.memory[address] = value;
 
+        if (cpu.writeObserver) {
+            cpu.writeObserver(address, value);
+        }
+
         // Only track if tracking is enabled
         if (cpu.trackingEnabled) {
             cpu.memoryAccess[address] |= MEM_WRITE;
             cpu.lastWritePC[address] = cpu.pc;
+            cpu.writeEpoch[address] = cpu.epoch;
+            cpu.liveness[address] |= (cpu.phase == PHASE_PLAY) ? LIVE_PLAY_WRITE : LIVE_INIT_WRITE;
+            track_use(address);
 
             // Track zero page writes
             if (address < 256) {
@@ -184,6 +270,9 @@ extern "C" {
                 cpu.ciaTimerHi = value;
                 cpu.ciaTimerWritten = true;
             }
+            if (address == 0xDC04 || address == 0xDC05) {
+                cpu.timerWrites.push_back({ cpu.epoch, uint16_t(cpu.ciaTimerLo | (cpu.ciaTimerHi << 8)) });
+            }
         }
     }
 
@@ -219,7 +308,11 @@ extern "C" {
 
     // === Addressing & micro-helpers =============================================
     inline uint8_t rd(uint16_t addr) {
-        if (cpu.trackingEnabled) cpu.memoryAccess[addr] |= MEM_READ;
+        if (cpu.trackingEnabled) {
+            cpu.memoryAccess[addr] |= MEM_READ;
+            track_read_in(addr);
+            track_use(addr);
+        }
         return cpu.memory[addr];
     }
     inline bool page_crossed(uint16_t a, uint16_t b) { return (a & 0xFF00) != (b & 0xFF00); }
@@ -303,14 +396,87 @@ extern "C" {
     }
     // =============================================================================
 
+    // Record the zero-page footprint of the instruction at `instr`, using the
+    // current register values to see how far indexed modes reach.
+    void track_zp_operand(uint16_t instr, uint8_t opcode) {
+        uint8_t lo = cpu.memory[uint16_t(instr + 1)];
+        uint8_t hi = cpu.memory[uint16_t(instr + 2)];
+        uint16_t span = 0;
+        uint16_t ea = 0xFFFF;
+
+        switch (opcodeTable[opcode].mode) {
+        case MODE_ZERO_PAGE: span = 1; break;
+        case MODE_ZERO_PAGE_X: span = 1 + cpu.x; break;
+        case MODE_ZERO_PAGE_Y: span = 1 + cpu.y; break;
+        case MODE_INDIRECT_X: {
+            uint8_t z = (lo + cpu.x) & 0xFF;
+            span = 2 + cpu.x;
+            cpu.zpFlags[z] |= ZP_POINTER;
+            ea = cpu.memory[z] | (cpu.memory[(z + 1) & 0xFF] << 8);
+        } break;
+        case MODE_INDIRECT_Y:
+            span = 2;
+            cpu.zpFlags[lo] |= ZP_POINTER;
+            ea = uint16_t((cpu.memory[lo] | (cpu.memory[(lo + 1) & 0xFF] << 8)) + cpu.y);
+            break;
+        case MODE_ABSOLUTE: if (hi == 0) span = 1; break;
+        case MODE_ABSOLUTE_X:
+            if (hi == 0) span = 1 + cpu.x;
+            else ea = uint16_t((lo | (hi << 8)) + cpu.x);
+            break;
+        case MODE_ABSOLUTE_Y:
+            if (hi == 0) span = 1 + cpu.y;
+            else ea = uint16_t((lo | (hi << 8)) + cpu.y);
+            break;
+        case MODE_INDIRECT:
+            if (hi == 0) {
+                span = 2;
+                cpu.zpFlags[lo] |= ZP_POINTER;
+            }
+            break;
+        default: break;
+        }
+
+        if (span > cpu.zpOperandSpan[instr]) {
+            cpu.zpOperandSpan[instr] = span;
+        }
+
+        // Zero page reached through a pointer or a wrapping absolute index
+        // has no operand naming it, so it cannot be moved.
+        if (ea < 0x100) {
+            cpu.zpFlags[ea] |= ZP_UNPATCHABLE;
+        }
+
+        // Code running in zero page would need its jump targets relocated.
+        for (uint16_t i = 0; i < opcodeTable[opcode].size; i++) {
+            if (instr + i < 0x100) {
+                cpu.zpFlags[instr + i] |= ZP_UNPATCHABLE;
+            }
+        }
+    }
+
     // Execute one instruction
     EMSCRIPTEN_KEEPALIVE
         void cpu_step() {
+        if (cpu.stepObserver) {
+            cpu.stepObserver(cpu.pc);
+        }
+
         uint16_t pc = cpu.pc;
         uint8_t opcode = cpu.memory[pc++];
 
         if (cpu.trackingEnabled) {
             cpu.memoryAccess[cpu.pc] |= MEM_EXECUTE | MEM_OPCODE;
+
+            // Instruction bytes count as reads for liveness so that operands
+            // patched by self-modifying code in an earlier call are kept.
+            uint8_t size = opcodeTable[opcode].size ? opcodeTable[opcode].size : 1;
+            for (uint8_t i = 0; i < size; i++) {
+                track_read_in(uint16_t(cpu.pc + i));
+                track_use(uint16_t(cpu.pc + i));
+            }
+
+            track_zp_operand(cpu.pc, opcode);
         }
 
         switch (opcode) {
@@ -323,10 +489,7 @@ extern "C" {
         case 0xA5: // LDA zero page
         {
             uint8_t zp = cpu.memory[pc++];
-            cpu.a = cpu.memory[zp];
-            if (cpu.trackingEnabled) {
-                cpu.memoryAccess[zp] |= MEM_READ;
-            }
+            cpu.a = rd(zp);
             set_zn_flags(cpu.a);
             cpu.cycles += 3;
         }
@@ -335,10 +498,7 @@ extern "C" {
         case 0xAD: // LDA absolute
         {
             uint16_t addr = read_word(pc);
-            cpu.a = cpu.memory[addr];
-            if (cpu.trackingEnabled) {
-                cpu.memoryAccess[addr] |= MEM_READ;
-            }
+            cpu.a = rd(addr);
             set_zn_flags(cpu.a);
             cpu.cycles += 4;
         }
@@ -354,10 +514,7 @@ extern "C" {
         case 0xB5: // LDA zero page,X
         {
             uint8_t zp = (cpu.memory[pc++] + cpu.x) & 0xFF;
-            cpu.a = cpu.memory[zp];
-            if (cpu.trackingEnabled) {
-                cpu.memoryAccess[zp] |= MEM_READ;
-            }
+            cpu.a = rd(zp);
             set_zn_flags(cpu.a);
             cpu.cycles += 4;
         }
@@ -366,11 +523,8 @@ extern "C" {
         case 0xA1: // LDA (indirect,X)
         {
             uint8_t zp = (cpu.memory[pc++] + cpu.x) & 0xFF;
-            uint16_t addr = cpu.memory[zp] | (cpu.memory[(zp + 1) & 0xFF] << 8);
-            cpu.a = cpu.memory[addr];
-            if (cpu.trackingEnabled) {
-                cpu.memoryAccess[addr] |= MEM_READ;
-            }
+            uint16_t addr = rd(zp) | (rd((zp + 1) & 0xFF) << 8);
+            cpu.a = rd(addr);
             set_zn_flags(cpu.a);
             cpu.cycles += 6;
         }
@@ -420,7 +574,7 @@ extern "C" {
         case 0x81: // STA (indirect,X)
         {
             uint8_t zp = (cpu.memory[pc++] + cpu.x) & 0xFF;
-            uint16_t addr = cpu.memory[zp] | (cpu.memory[(zp + 1) & 0xFF] << 8);
+            uint16_t addr = rd(zp) | (rd((zp + 1) & 0xFF) << 8);
             write_memory_internal(addr, cpu.a);
             cpu.cycles += 6;
         }
@@ -429,7 +583,7 @@ extern "C" {
         case 0x91: // STA (indirect),Y
         {
             uint8_t zp = cpu.memory[pc++];
-            uint16_t addr = (cpu.memory[zp] | (cpu.memory[(zp + 1) & 0xFF] << 8)) + cpu.y;
+            uint16_t addr = (rd(zp) | (rd((zp + 1) & 0xFF) << 8)) + cpu.y;
             write_memory_internal(addr, cpu.a);
             cpu.cycles += 6;
         }
@@ -495,10 +649,7 @@ extern "C" {
         case 0xA6: // LDX zero page
         {
             uint8_t zp = cpu.memory[pc++];
-            cpu.x = cpu.memory[zp];
-            if (cpu.trackingEnabled) {
-                cpu.memoryAccess[zp] |= MEM_READ;
-            }
+            cpu.x = rd(zp);
             set_zn_flags(cpu.x);
             cpu.cycles += 3;
         }
@@ -507,10 +658,7 @@ extern "C" {
         case 0xAE: // LDX absolute
         {
             uint16_t addr = read_word(pc);
-            cpu.x = cpu.memory[addr];
-            if (cpu.trackingEnabled) {
-                cpu.memoryAccess[addr] |= MEM_READ;
-            }
+            cpu.x = rd(addr);
             set_zn_flags(cpu.x);
             cpu.cycles += 4;
         }
@@ -519,10 +667,7 @@ extern "C" {
         case 0xB6: // LDX zero page,Y
         {
             uint8_t zp = (cpu.memory[pc++] + cpu.y) & 0xFF;
-            cpu.x = cpu.memory[zp];
-            if (cpu.trackingEnabled) {
-                cpu.memoryAccess[zp] |= MEM_READ;
-            }
+            cpu.x = rd(zp);
             set_zn_flags(cpu.x);
             cpu.cycles += 4;
         }
@@ -538,10 +683,7 @@ extern "C" {
         case 0xA4: // LDY zero page
         {
             uint8_t zp = cpu.memory[pc++];
-            cpu.y = cpu.memory[zp];
-            if (cpu.trackingEnabled) {
-                cpu.memoryAccess[zp] |= MEM_READ;
-            }
+            cpu.y = rd(zp);
             set_zn_flags(cpu.y);
             cpu.cycles += 3;
         }
@@ -550,10 +692,7 @@ extern "C" {
         case 0xAC: // LDY absolute
         {
             uint16_t addr = read_word(pc);
-            cpu.y = cpu.memory[addr];
-            if (cpu.trackingEnabled) {
-                cpu.memoryAccess[addr] |= MEM_READ;
-            }
+            cpu.y = rd(addr);
             set_zn_flags(cpu.y);
             cpu.cycles += 4;
         }
@@ -562,10 +701,7 @@ extern "C" {
         case 0xB4: // LDY zero page,X
         {
             uint8_t zp = (cpu.memory[pc++] + cpu.x) & 0xFF;
-            cpu.y = cpu.memory[zp];
-            if (cpu.trackingEnabled) {
-                cpu.memoryAccess[zp] |= MEM_READ;
-            }
+            cpu.y = rd(zp);
             set_zn_flags(cpu.y);
             cpu.cycles += 4;
         }
@@ -730,10 +866,10 @@ extern "C" {
             // from the same page ($xx00) instead of crossing into the next page.
             uint16_t addr;
             if ((ptr & 0xFF) == 0xFF) {
-                addr = cpu.memory[ptr] | (cpu.memory[ptr & 0xFF00] << 8);
+                addr = rd(ptr) | (rd(ptr & 0xFF00) << 8);
             }
             else {
-                addr = cpu.memory[ptr] | (cpu.memory[ptr + 1] << 8);
+                addr = rd(ptr) | (rd(ptr + 1) << 8);
             }
             pc = addr;
             if (cpu.trackingEnabled) {
@@ -792,7 +928,7 @@ extern "C" {
         case 0xC5: // CMP zero page
         {
             uint8_t zp = cpu.memory[pc++];
-            uint8_t value = cpu.memory[zp];
+            uint8_t value = rd(zp);
             uint8_t result = cpu.a - value;
             set_flag(FLAG_CARRY, cpu.a >= value);
             set_zn_flags(result);
@@ -803,7 +939,7 @@ extern "C" {
         case 0xCD: // CMP absolute
         {
             uint16_t addr = read_word(pc);
-            uint8_t value = cpu.memory[addr];
+            uint8_t value = rd(addr);
             uint8_t result = cpu.a - value;
             set_flag(FLAG_CARRY, cpu.a >= value);
             set_zn_flags(result);
@@ -825,7 +961,7 @@ extern "C" {
         case 0xE4: // CPX zero page
         {
             uint8_t zp = cpu.memory[pc++];
-            uint8_t value = cpu.memory[zp];
+            uint8_t value = rd(zp);
             uint8_t result = cpu.x - value;
             set_flag(FLAG_CARRY, cpu.x >= value);
             set_zn_flags(result);
@@ -847,7 +983,7 @@ extern "C" {
         case 0xC4: // CPY zero page
         {
             uint8_t zp = cpu.memory[pc++];
-            uint8_t value = cpu.memory[zp];
+            uint8_t value = rd(zp);
             uint8_t result = cpu.y - value;
             set_flag(FLAG_CARRY, cpu.y >= value);
             set_zn_flags(result);
@@ -865,7 +1001,7 @@ extern "C" {
         case 0x25: // AND zero page
         {
             uint8_t zp = cpu.memory[pc++];
-            cpu.a &= cpu.memory[zp];
+            cpu.a &= rd(zp);
             set_zn_flags(cpu.a);
             cpu.cycles += 3;
         }
@@ -880,7 +1016,7 @@ extern "C" {
         case 0x05: // ORA zero page
         {
             uint8_t zp = cpu.memory[pc++];
-            cpu.a |= cpu.memory[zp];
+            cpu.a |= rd(zp);
             set_zn_flags(cpu.a);
             cpu.cycles += 3;
         }
@@ -895,7 +1031,7 @@ extern "C" {
         case 0x45: // EOR zero page
         {
             uint8_t zp = cpu.memory[pc++];
-            cpu.a ^= cpu.memory[zp];
+            cpu.a ^= rd(zp);
             set_zn_flags(cpu.a);
             cpu.cycles += 3;
         }
@@ -905,7 +1041,7 @@ extern "C" {
         case 0x24: // BIT zero page
         {
             uint8_t zp = cpu.memory[pc++];
-            uint8_t value = cpu.memory[zp];
+            uint8_t value = rd(zp);
             set_flag(FLAG_ZERO, (cpu.a & value) == 0);
             set_flag(FLAG_NEGATIVE, value & 0x80);
             set_flag(FLAG_OVERFLOW, value & 0x40);
@@ -916,7 +1052,7 @@ extern "C" {
         case 0x2C: // BIT absolute
         {
             uint16_t addr = read_word(pc);
-            uint8_t value = cpu.memory[addr];
+            uint8_t value = rd(addr);
             set_flag(FLAG_ZERO, (cpu.a & value) == 0);
             set_flag(FLAG_NEGATIVE, value & 0x80);
             set_flag(FLAG_OVERFLOW, value & 0x40);
@@ -962,7 +1098,7 @@ extern "C" {
         case 0x06: // ASL zero page
         {
             uint8_t zp = cpu.memory[pc++];
-            uint8_t value = cpu.memory[zp];
+            uint8_t value = rd(zp);
             set_flag(FLAG_CARRY, value & 0x80);
             value <<= 1;
             write_memory_internal(zp, value);
@@ -981,7 +1117,7 @@ extern "C" {
         case 0x46: // LSR zero page
         {
             uint8_t zp = cpu.memory[pc++];
-            uint8_t value = cpu.memory[zp];
+            uint8_t value = rd(zp);
             set_flag(FLAG_CARRY, value & 0x01);
             value >>= 1;
             write_memory_internal(zp, value);
@@ -1003,7 +1139,7 @@ extern "C" {
         case 0x26: // ROL zero page
         {
             uint8_t zp = cpu.memory[pc++];
-            uint8_t value = cpu.memory[zp];
+            uint8_t value = rd(zp);
             bool old_carry = test_flag(FLAG_CARRY);
             set_flag(FLAG_CARRY, value & 0x80);
             value = (value << 1) | (old_carry ? 1 : 0);
@@ -1026,7 +1162,7 @@ extern "C" {
         case 0x66: // ROR zero page
         {
             uint8_t zp = cpu.memory[pc++];
-            uint8_t value = cpu.memory[zp];
+            uint8_t value = rd(zp);
             bool old_carry = test_flag(FLAG_CARRY);
             set_flag(FLAG_CARRY, value & 0x01);
             value = (value >> 1) | (old_carry ? 0x80 : 0);
@@ -1371,6 +1507,12 @@ extern "C" {
         return 0;  // cycle limit hit
     }
 
+    // Install (or clear, with nullptr) the step/write observers. C++ only.
+    void cpu_set_observers(void (*stepObserver)(uint16_t), void (*writeObserver)(uint16_t, uint8_t)) {
+        cpu.stepObserver = stepObserver;
+        cpu.writeObserver = writeObserver;
+    }
+
     // Get CPU state
     EMSCRIPTEN_KEEPALIVE
         uint16_t cpu_get_pc() { return cpu.pc; }
@@ -1405,6 +1547,25 @@ extern "C" {
         return cpu.ciaTimerWritten;
     }
 
+    // Timer latch write log since the last reset, oldest first.
+    EMSCRIPTEN_KEEPALIVE
+        uint32_t cpu_get_timer_write_count() {
+        return cpu.timerWrites.size();
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+        uint32_t cpu_get_timer_write_epoch(uint32_t index) {
+        if (index >= cpu.timerWrites.size()) return 0;
+        return cpu.timerWrites[index].epoch;
+    }
+
+    // Latch value (lo | hi << 8) after the write.
+    EMSCRIPTEN_KEEPALIVE
+        uint16_t cpu_get_timer_write_latch(uint32_t index) {
+        if (index >= cpu.timerWrites.size()) return 0;
+        return cpu.timerWrites[index].latch;
+    }
+
     EMSCRIPTEN_KEEPALIVE
         uint64_t cpu_get_cycles() { return cpu.cycles; }
 
@@ -1417,6 +1578,19 @@ extern "C" {
         return cpu.memoryAccess[address];
     }
 
+    // Whether an instruction started at this address.
+    EMSCRIPTEN_KEEPALIVE
+        bool cpu_is_instruction_start(uint16_t address) {
+        return (cpu.memoryAccess[address] & MEM_OPCODE) != 0;
+    }
+
+    // Whether an instruction read this address as data (instruction fetches
+    // do not count).
+    EMSCRIPTEN_KEEPALIVE
+        bool cpu_is_data_read(uint16_t address) {
+        return (cpu.memoryAccess[address] & MEM_READ) != 0;
+    }
+
     // Get SID write statistics
     EMSCRIPTEN_KEEPALIVE
         uint32_t cpu_get_sid_writes(uint8_t reg) {
@@ -1566,6 +1740,7 @@ extern "C" {
         cpu.ciaTimerLo = 0;
         cpu.ciaTimerHi = 0;
         cpu.ciaTimerWritten = false;
+        cpu.timerWrites.clear();
         cpu.totalSidWrites = 0;
         cpu.totalZpWrites = 0;
         cpu.recordWrites = false;
@@ -1577,6 +1752,73 @@ extern "C" {
         memset(cpu.zpWrites, 0, sizeof(cpu.zpWrites));
         memset(cpu.lastWritePC, 0, sizeof(cpu.lastWritePC));
         cpu.writeSequence.clear();
+
+        cpu.epoch = 0;
+        cpu.phase = PHASE_INIT;
+        memset(cpu.writeEpoch, 0, sizeof(cpu.writeEpoch));
+        memset(cpu.liveness, 0, sizeof(cpu.liveness));
+        memset(cpu.firstUse, 0, sizeof(cpu.firstUse));
+        memset(cpu.lastUse, 0, sizeof(cpu.lastUse));
+        memset(cpu.zpOperandSpan, 0, sizeof(cpu.zpOperandSpan));
+        memset(cpu.zpFlags, 0, sizeof(cpu.zpFlags));
+    }
+
+    // Start a new liveness epoch. Call before each init or play invocation
+    // so reads can be classified as consuming a carried-in value or not.
+    EMSCRIPTEN_KEEPALIVE
+        void cpu_begin_epoch(uint8_t phase) {
+        cpu.epoch++;
+        cpu.phase = phase;
+    }
+
+    // Accumulated LivenessFlag bits for an address since the last reset.
+    EMSCRIPTEN_KEEPALIVE
+        uint8_t cpu_get_liveness(uint16_t address) {
+        return cpu.liveness[address];
+    }
+
+    // Whether play calls both write an address and read back what an
+    // earlier call left there: state a save/restore must carry.
+    EMSCRIPTEN_KEEPALIVE
+        bool cpu_is_play_live(uint16_t address) {
+        const uint8_t flags = LIVE_PLAY_WRITE | LIVE_PLAY_READ_IN;
+        return (cpu.liveness[address] & flags) == flags;
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+        uint16_t cpu_get_zp_operand_span(uint16_t address) {
+        return cpu.zpOperandSpan[address];
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+        uint8_t cpu_get_zp_flags(uint8_t zp) {
+        return cpu.zpFlags[zp];
+    }
+
+    // Whether a zero-page byte is the low half of a pointer, so it must stay
+    // next to the byte after it.
+    EMSCRIPTEN_KEEPALIVE
+        bool cpu_is_zp_pointer(uint8_t zp) {
+        return (cpu.zpFlags[zp] & ZP_POINTER) != 0;
+    }
+
+    // Whether a zero-page byte is reached in a way no operand patch can
+    // follow, so it must stay where it is.
+    EMSCRIPTEN_KEEPALIVE
+        bool cpu_is_zp_unpatchable(uint8_t zp) {
+        return (cpu.zpFlags[zp] & ZP_UNPATCHABLE) != 0;
+    }
+
+    // First/last epoch an address was touched in (0 = never, 1 = init,
+    // 2 + N = play call N since the last reset).
+    EMSCRIPTEN_KEEPALIVE
+        uint16_t cpu_get_first_use(uint16_t address) {
+        return cpu.firstUse[address];
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+        uint16_t cpu_get_last_use(uint16_t address) {
+        return cpu.lastUse[address];
     }
 
 } // extern "C"
\ No newline at end of file
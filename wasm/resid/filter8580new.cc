@@ -28,6 +28,7 @@
 #include "dac.h"
 #include "spline.h"
 #include <math.h>
+#include <mutex>
 
 namespace reSID
 {
@@ -250,8 +251,12 @@ static const double Vref = 4.7975; // 4.75V +1%
 // ----------------------------------------------------------------------------
 Filter::Filter()
 {
+  static std::mutex class_init_lock;
   static bool class_init;
 
+  // Model parameters and the small tables, shared by every filter. The
+  // large gain tables are left to set_chip_model() (see build_gain_tables()).
+  std::lock_guard<std::mutex> lock(class_init_lock);
   if (!class_init) {
     double tmp_n_param[2];
 
@@ -276,7 +281,6 @@ Filter::Filter()
       // Scaling and translation constants.
       double N16 = norm*((1u << 16) - 1);
       double N30 = norm*((1u << 30) - 1);
-      double N31 = norm*((1u << 31) - 1);
       mf.vo_N16 = N16;
 
       // In the 6581 the mixer input resistors for the filter lines
@@ -298,138 +302,7 @@ Filter::Filter()
 
       tmp_n_param[m] = denorm*(1 << 13)*((fi.uCox/2.)*1.0e-6/fi.C);
 
-      // Create lookup table mapping op-amp voltage across output and input
-      // to input voltage: vo - vx -> vx
-      // FIXME: No variable length arrays in ISO C++, hardcoding to max 50
-      // points.
-      // double_point scaled_voltage[fi.opamp_voltage_size];
-      double_point scaled_voltage[50];
-
-      assert((fi.opamp_voltage_size > 0) && (fi.opamp_voltage_size < 50));
-
-      for (int i = 0; i < fi.opamp_voltage_size; i++) {
-        // The target output range is 16 bits, in order to fit in an unsigned
-        // short.
-        //
-        // The y axis is temporarily scaled to 31 bits for maximum accuracy in
-        // the calculated derivative.
-        //
-        // Values are normalized using
-        //
-        //   x_n = m*2^N*(x - xmin)
-        //
-        // and are translated back later (for fixed point math) using
-        //
-        //   m*2^N*x = x_n - m*2^N*xmin
-        //
-        scaled_voltage[fi.opamp_voltage_size - 1 - i][0] = N16*(fi.opamp_voltage[i][1] - fi.opamp_voltage[i][0])/2.;
-        // Translate value to the positive axis by adding 32768
-        // The same is done later in the integrator function when accessing the opamp array
-        scaled_voltage[fi.opamp_voltage_size - 1 - i][0] += double(1 << 15);
-        scaled_voltage[fi.opamp_voltage_size - 1 - i][1] = N31*(fi.opamp_voltage[i][0] - vmin);
-      }
-
-      // Clamp x to 16 bit range (rounding may cause overflow).
-      if (scaled_voltage[fi.opamp_voltage_size - 1][0] > 65535.) {
-        // The last point is repeated.
-        scaled_voltage[fi.opamp_voltage_size - 1][0] =
-            scaled_voltage[fi.opamp_voltage_size - 2][0] = 65535.;
-      }
-
-      interpolate(scaled_voltage, scaled_voltage + fi.opamp_voltage_size - 1,
-                    PointPlotter<unsigned int>(voltages), 1.0);
-
-      // Store both fn and dfn in the same table.
-      mf.ak = (int)(scaled_voltage[0][0] + 0.5);
-      mf.bk = (int)(scaled_voltage[fi.opamp_voltage_size - 1][0] + 0.5);
-      int j;
-      for (j = 0; j < mf.ak; j++) {
-        opamp[j].vx = 0;
-        opamp[j].dvx = 0;
-      }
-      unsigned int f = voltages[j];
-      for (; j < mf.bk; j++) {
-        unsigned int fp = f;
-        f = voltages[j];  // Scaled by m*2^31
-        // m*2^31*dy/1 = (m*2^31*dy)/(m*2^16*dx) = 2^15*dy/dx
-        int df = f - fp;  // Scaled by 2^15
-
-        // 16 bits unsigned: m*2^16*(fn - xmin)
-        opamp[j].vx = f > (0xffff << 15) ? 0xffff : f >> 15;
-        // 16 bits (15 bits + sign bit): 2^11*dfn
-        opamp[j].dvx = df >> (15 - 11);
-      }
-      for (; j < (1 << 16); j++) {
-        opamp[j].vx = 0;
-        opamp[j].dvx = 0;
-      }
-
-      // We don't have the differential for the first point so just assume
-      // it's the same as the second point's
-      opamp[mf.ak].dvx = opamp[mf.ak+1].dvx;
-
-      // Create lookup tables.
-
-      // The filter summer operates at n ~ 1, and has 5 fundamentally different
-      // input configurations (2 - 6 input "resistors").
-      //
-      // Note that all "on" transistors are modeled as one. This is not
-      // entirely accurate, since the input for each transistor is different,
-      // and transistors are not linear components. However modeling all
-      // transistors separately would be extremely costly.
-      int offset = 0;
-      int size;
-      for (int k = 0; k < 5; k++) {
-        int idiv = 2 + k;        // 2 - 6 input "resistors".
-        double n_idiv = double(idiv);
-        size = idiv << 16;
-        int x = mf.ak;
-        for (int vi = 0; vi < size; vi++) {
-          mf.summer[offset + vi] =
-            solve_gain_d(opamp, n_idiv, vi/idiv, x, mf);
-        }
-        offset += size;
-      }
-
-      // The audio mixer operates at n ~ 8/6 (6581) 8/5 (8580),
-      // and has 8 fundamentally different
-      // input configurations (0 - 7 input "resistors").
-      //
-      // All "on", transistors are modeled as one - see comments above for
-      // the filter summer.
-      double divider = m==0 ? 6. : 5.;
-      offset = 0;
-      size = 1;  // Only one lookup element for 0 input "resistors".
-      for (int l = 0; l < 8; l++) {
-        int idiv = l;                 // 0 - 7 input "resistors".
-        double n_idiv = double(idiv << 3)/divider; // n*idiv
-        if (idiv == 0) {
-          // Avoid division by zero; the result will be correct since
-          // n_idiv = 0.
-          idiv = 1;
-        }
-        int x = mf.ak;
-        for (int vi = 0; vi < size; vi++) {
-          mf.mixer[offset + vi] =
-            solve_gain_d(opamp, n_idiv, vi/idiv, x, mf);
-        }
-        offset += size;
-        size = (l + 1) << 16;
-      }
-
-      // 4 bit "resistor" ladders in the audio
-      // output gain necessitate 16 gain tables.
-      // From die photographs of the volume "resistor" ladders
-      // it follows that gain ~ vol/12 (6581) vol/16 (8580)
-      // (assuming ideal op-amps and ideal "resistors").
-      divider = m==0 ? 12. : 16.;
-      for (int n8 = 0; n8 < 16; n8++) {
-        double n = double(n8) / divider;
-        int x = mf.ak;
-        for (int vi = 0; vi < (1 << 16); vi++) {
-          mf.gain[n8][vi] = solve_gain_d(opamp, n, vi, x, mf);
-        }
-      }
+      build_opamp(m, voltages, opamp);
 
       // Create lookup table mapping capacitor voltage to op-amp input voltage:
       // vc -> vx
@@ -443,30 +316,6 @@ Filter::Filter()
       if (m == 0) {
         // 6581 only
 
-        // In the MOS 6581, 1/Q is controlled linearly by res. From die photographs
-        // of the resonance "resistor" ladder it follows that 1/Q ~ ~res/8
-        // (assuming an ideal op-amp and ideal "resistors"). This implies that Q
-        // ranges from 0.533 (res = 0) to 8 (res = E). For res = F, Q is actually
-        // theoretically unlimited, which is quite unheard of in a filter
-        // circuit.
-        //
-        // To obtain Q ~ 1/sqrt(2) = 0.707 for maximally flat frequency response,
-        // res should be set to 4: Q = 8/~4 = 8/11 = 0.7272 (again assuming an ideal
-        // op-amp and ideal "resistors").
-        //
-        // Q as low as 0.707 is not achievable because of low gain op-amps; res = 0
-        // should yield the flattest possible frequency response at Q ~ 0.8 - 1.0
-        // in the op-amp's pseudo-linear range (high amplitude signals will be
-        // clipped). As resonance is increased, the filter must be clocked more
-        // often to keep it stable.
-        for (int n8 = 0; n8 < 16; n8++) {
-          double n = double(~n8 & 0xf) / 8.;
-          int x = mf.ak;
-          for (int vi = 0; vi < (1 << 16); vi++) {
-            mf.resonance[n8][vi] = solve_gain_d(opamp, n, vi, x, mf);
-          }
-        }
-
         Vw_bias = 0;
 
         // Normalized snake current factor, 1 cycle at 1MHz.
@@ -524,78 +373,6 @@ Filter::Filter()
       } else {
         // 8580 only
 
-        // In the MOS 8580, the resonance "resistor" ladder above the bp feedback
-        // op-amp is split in two parts; one ladder for the op-amp input and one
-        // ladder for the op-amp feedback.
-        //
-        // input:         feedback:
-        //
-        //             Rf
-        // Ri R4 RC R8    R3
-        //             R2
-        //             R1
-        //
-        //
-        // The "resistors" are switched in as follows by bits in register $17:
-        //
-        // feedback:
-        // R1: bit4&!bit5
-        // R2: !bit4&bit5
-        // R3: bit4&bit5
-        // Rf: always on
-        //
-        // input:
-        // R4: bit6&!bit7
-        // R8: !bit6&bit7
-        // RC: bit6&bit7
-        // Ri: !(R4|R8|RC) = !(bit6|bit7) = !bit6&!bit7
-        //
-        //
-        // The relative "resistor" values are approximately (using channel length):
-        //
-        // R1 = 15.3*Ri
-        // R2 =  7.3*Ri
-        // R3 =  4.7*Ri
-        // Rf =  1.4*Ri
-        // R4 =  1.4*Ri
-        // R8 =  2.0*Ri
-        // RC =  2.8*Ri
-        //
-        //
-        // Approximate values for 1/Q can now be found as follows (assuming an
-        // ideal op-amp):
-        //
-        // res  feedback  input  -gain (1/Q)
-        // ---  --------  -----  ----------
-        // 0   Rf        Ri     Rf/Ri      = 1/(Ri*(1/Rf))      = 1/0.71
-        // 1   Rf|R1     Ri     (Rf|R1)/Ri = 1/(Ri*(1/Rf+1/R1)) = 1/0.78
-        // 2   Rf|R2     Ri     (Rf|R2)/Ri = 1/(Ri*(1/Rf+1/R2)) = 1/0.85
-        // 3   Rf|R3     Ri     (Rf|R3)/Ri = 1/(Ri*(1/Rf+1/R3)) = 1/0.92
-        // 4   Rf        R4     Rf/R4      = 1/(R4*(1/Rf))      = 1/1.00
-        // 5   Rf|R1     R4     (Rf|R1)/R4 = 1/(R4*(1/Rf+1/R1)) = 1/1.10
-        // 6   Rf|R2     R4     (Rf|R2)/R4 = 1/(R4*(1/Rf+1/R2)) = 1/1.20
-        // 7   Rf|R3     R4     (Rf|R3)/R4 = 1/(R4*(1/Rf+1/R3)) = 1/1.30
-        // 8   Rf        R8     Rf/R8      = 1/(R8*(1/Rf))      = 1/1.43
-        // 9   Rf|R1     R8     (Rf|R1)/R8 = 1/(R8*(1/Rf+1/R1)) = 1/1.56
-        // A   Rf|R2     R8     (Rf|R2)/R8 = 1/(R8*(1/Rf+1/R2)) = 1/1.70
-        // B   Rf|R3     R8     (Rf|R3)/R8 = 1/(R8*(1/Rf+1/R3)) = 1/1.86
-        // C   Rf        RC     Rf/RC      = 1/(RC*(1/Rf))      = 1/2.00
-        // D   Rf|R1     RC     (Rf|R1)/RC = 1/(RC*(1/Rf+1/R1)) = 1/2.18
-        // E   Rf|R2     RC     (Rf|R2)/RC = 1/(RC*(1/Rf+1/R2)) = 1/2.38
-        // F   Rf|R3     RC     (Rf|R3)/RC = 1/(RC*(1/Rf+1/R3)) = 1/2.60
-        //
-        //
-        // These data indicate that the following function for 1/Q has been
-        // modeled in the MOS 8580:
-        //
-        // 1/Q = 2^(1/2)*2^(-x/8) = 2^(1/2 - x/8) = 2^((4 - x)/8)
-        for (int n8 = 0; n8 < 16; n8++) {
-          int x = mf.ak;
-          for (int vi = 0; vi < (1 << 16); vi++) {
-            mf.resonance[n8][vi] = solve_gain_d(opamp, resGain[n8], vi, x, mf);
-          }
-        }
-
         // scaled 5 bits
         n_param = (int)(tmp_n_param[1] * 32 + 0.5);
 
@@ -628,14 +405,303 @@ Filter::Filter()
     class_init = true;
   }
 
+  // Per-instance bias state. The table setup above only sets it for the
+  // first filter constructed, leaving every other chip uninitialized.
+  adjust_filter_bias(0);
+
+  // MOS6581 until set_chip_model(), which builds the model's gain tables;
+  // SID::clock() builds them if nothing else has.
+  sid_model = MOS6581;
+  tables_ready = false;
+
   enable_filter(true);
-  set_chip_model(MOS6581);
   set_voice_mask(0x07);
   input(0);
   reset();
 }
 
 
+// ----------------------------------------------------------------------------
+// Op-amp transfer function of model m as a table vo - vx -> vx, with its
+// derivative, and the root bracket ak, bk for solve_gain_d(). voltages is
+// scratch space for 1 << 16 entries.
+// ----------------------------------------------------------------------------
+void Filter::build_opamp(int m, unsigned int* voltages, opamp_t* opamp)
+{
+  model_filter_init_t& fi = model_filter_init[m];
+  model_filter_t& mf = model_filter[m];
+
+  // Scaling and translation constants, as in the constructor.
+  double vmin = fi.opamp_voltage[0][0];
+  double opamp_max = fi.opamp_voltage[0][1];
+  double kVddt = fi.k*(fi.Vdd - fi.Vth);
+  double vmax = kVddt < opamp_max ? opamp_max : kVddt;
+  double norm = 1.0/(vmax - vmin);
+  double N16 = norm*((1u << 16) - 1);
+  double N31 = norm*((1u << 31) - 1);
+
+  // Create lookup table mapping op-amp voltage across output and input
+  // to input voltage: vo - vx -> vx
+  // FIXME: No variable length arrays in ISO C++, hardcoding to max 50
+  // points.
+  // double_point scaled_voltage[fi.opamp_voltage_size];
+  double_point scaled_voltage[50];
+
+  assert((fi.opamp_voltage_size > 0) && (fi.opamp_voltage_size < 50));
+
+  for (int i = 0; i < fi.opamp_voltage_size; i++) {
+    // The target output range is 16 bits, in order to fit in an unsigned
+    // short.
+    //
+    // The y axis is temporarily scaled to 31 bits for maximum accuracy in
+    // the calculated derivative.
+    //
+    // Values are normalized using
+    //
+    //   x_n = m*2^N*(x - xmin)
+    //
+    // and are translated back later (for fixed point math) using
+    //
+    //   m*2^N*x = x_n - m*2^N*xmin
+    //
+    scaled_voltage[fi.opamp_voltage_size - 1 - i][0] = N16*(fi.opamp_voltage[i][1] - fi.opamp_voltage[i][0])/2.;
+    // Translate value to the positive axis by adding 32768
+    // The same is done later in the integrator function when accessing the opamp array
+    scaled_voltage[fi.opamp_voltage_size - 1 - i][0] += double(1 << 15);
+    scaled_voltage[fi.opamp_voltage_size - 1 - i][1] = N31*(fi.opamp_voltage[i][0] - vmin);
+  }
+
+  // Clamp x to 16 bit range (rounding may cause overflow).
+  if (scaled_voltage[fi.opamp_voltage_size - 1][0] > 65535.) {
+    // The last point is repeated.
+    scaled_voltage[fi.opamp_voltage_size - 1][0] =
+        scaled_voltage[fi.opamp_voltage_size - 2][0] = 65535.;
+  }
+
+  interpolate(scaled_voltage, scaled_voltage + fi.opamp_voltage_size - 1,
+                PointPlotter<unsigned int>(voltages), 1.0);
+
+  // Store both fn and dfn in the same table.
+  mf.ak = (int)(scaled_voltage[0][0] + 0.5);
+  mf.bk = (int)(scaled_voltage[fi.opamp_voltage_size - 1][0] + 0.5);
+  int j;
+  for (j = 0; j < mf.ak; j++) {
+    opamp[j].vx = 0;
+    opamp[j].dvx = 0;
+  }
+  unsigned int f = voltages[j];
+  for (; j < mf.bk; j++) {
+    unsigned int fp = f;
+    f = voltages[j];  // Scaled by m*2^31
+    // m*2^31*dy/1 = (m*2^31*dy)/(m*2^16*dx) = 2^15*dy/dx
+    int df = f - fp;  // Scaled by 2^15
+
+    // 16 bits unsigned: m*2^16*(fn - xmin)
+    opamp[j].vx = f > (0xffff << 15) ? 0xffff : f >> 15;
+    // 16 bits (15 bits + sign bit): 2^11*dfn
+    opamp[j].dvx = df >> (15 - 11);
+  }
+  for (; j < (1 << 16); j++) {
+    opamp[j].vx = 0;
+    opamp[j].dvx = 0;
+  }
+
+  // We don't have the differential for the first point so just assume
+  // it's the same as the second point's
+  opamp[mf.ak].dvx = opamp[mf.ak+1].dvx;
+}
+
+
+// ----------------------------------------------------------------------------
+// Summer, mixer, volume and resonance tables of one model: about 10 MB
+// solved point by point, which is most of reSID's startup time. They are
+// built the first time a chip is set to the model, once per process.
+// ----------------------------------------------------------------------------
+void Filter::build_gain_tables(chip_model model)
+{
+  static std::mutex build_lock;
+  static bool built[2];
+
+  std::lock_guard<std::mutex> lock(build_lock);
+  int m = model == MOS8580 ? 1 : 0;
+  if (built[m]) {
+    return;
+  }
+
+  model_filter_t& mf = model_filter[m];
+
+  // Temporary tables for op-amp transfer function.
+  unsigned int* voltages = new unsigned int[1 << 16];
+  opamp_t* opamp = new opamp_t[1 << 16];
+  build_opamp(m, voltages, opamp);
+  delete[] voltages;
+
+  // Create lookup tables.
+
+  // The filter summer operates at n ~ 1, and has 5 fundamentally different
+  // input configurations (2 - 6 input "resistors").
+  //
+  // Note that all "on" transistors are modeled as one. This is not
+  // entirely accurate, since the input for each transistor is different,
+  // and transistors are not linear components. However modeling all
+  // transistors separately would be extremely costly.
+  int offset = 0;
+  int size;
+  for (int k = 0; k < 5; k++) {
+    int idiv = 2 + k;        // 2 - 6 input "resistors".
+    double n_idiv = double(idiv);
+    size = idiv << 16;
+    int x = mf.ak;
+    for (int vi = 0; vi < size; vi++) {
+      mf.summer[offset + vi] =
+        solve_gain_d(opamp, n_idiv, vi/idiv, x, mf);
+    }
+    offset += size;
+  }
+
+  // The audio mixer operates at n ~ 8/6 (6581) 8/5 (8580),
+  // and has 8 fundamentally different
+  // input configurations (0 - 7 input "resistors").
+  //
+  // All "on", transistors are modeled as one - see comments above for
+  // the filter summer.
+  double divider = m==0 ? 6. : 5.;
+  offset = 0;
+  size = 1;  // Only one lookup element for 0 input "resistors".
+  for (int l = 0; l < 8; l++) {
+    int idiv = l;                 // 0 - 7 input "resistors".
+    double n_idiv = double(idiv << 3)/divider; // n*idiv
+    if (idiv == 0) {
+      // Avoid division by zero; the result will be correct since
+      // n_idiv = 0.
+      idiv = 1;
+    }
+    int x = mf.ak;
+    for (int vi = 0; vi < size; vi++) {
+      mf.mixer[offset + vi] =
+        solve_gain_d(opamp, n_idiv, vi/idiv, x, mf);
+    }
+    offset += size;
+    size = (l + 1) << 16;
+  }
+
+  // 4 bit "resistor" ladders in the audio
+  // output gain necessitate 16 gain tables.
+  // From die photographs of the volume "resistor" ladders
+  // it follows that gain ~ vol/12 (6581) vol/16 (8580)
+  // (assuming ideal op-amps and ideal "resistors").
+  divider = m==0 ? 12. : 16.;
+  for (int n8 = 0; n8 < 16; n8++) {
+    double n = double(n8) / divider;
+    int x = mf.ak;
+    for (int vi = 0; vi < (1 << 16); vi++) {
+      mf.gain[n8][vi] = solve_gain_d(opamp, n, vi, x, mf);
+    }
+  }
+
+  if (m == 0) {
+    // In the MOS 6581, 1/Q is controlled linearly by res. From die photographs
+    // of the resonance "resistor" ladder it follows that 1/Q ~ ~res/8
+    // (assuming an ideal op-amp and ideal "resistors"). This implies that Q
+    // ranges from 0.533 (res = 0) to 8 (res = E). For res = F, Q is actually
+    // theoretically unlimited, which is quite unheard of in a filter
+    // circuit.
+    //
+    // To obtain Q ~ 1/sqrt(2) = 0.707 for maximally flat frequency response,
+    // res should be set to 4: Q = 8/~4 = 8/11 = 0.7272 (again assuming an ideal
+    // op-amp and ideal "resistors").
+    //
+    // Q as low as 0.707 is not achievable because of low gain op-amps; res = 0
+    // should yield the flattest possible frequency response at Q ~ 0.8 - 1.0
+    // in the op-amp's pseudo-linear range (high amplitude signals will be
+    // clipped). As resonance is increased, the filter must be clocked more
+    // often to keep it stable.
+    for (int n8 = 0; n8 < 16; n8++) {
+      double n = double(~n8 & 0xf) / 8.;
+      int x = mf.ak;
+      for (int vi = 0; vi < (1 << 16); vi++) {
+        mf.resonance[n8][vi] = solve_gain_d(opamp, n, vi, x, mf);
+      }
+    }
+  } else {
+    // In the MOS 8580, the resonance "resistor" ladder above the bp feedback
+    // op-amp is split in two parts; one ladder for the op-amp input and one
+    // ladder for the op-amp feedback.
+    //
+    // input:         feedback:
+    //
+    //             Rf
+    // Ri R4 RC R8    R3
+    //             R2
+    //             R1
+    //
+    //
+    // The "resistors" are switched in as follows by bits in register $17:
+    //
+    // feedback:
+    // R1: bit4&!bit5
+    // R2: !bit4&bit5
+    // R3: bit4&bit5
+    // Rf: always on
+    //
+    // input:
+    // R4: bit6&!bit7
+    // R8: !bit6&bit7
+    // RC: bit6&bit7
+    // Ri: !(R4|R8|RC) = !(bit6|bit7) = !bit6&!bit7
+    //
+    //
+    // The relative "resistor" values are approximately (using channel length):
+    //
+    // R1 = 15.3*Ri
+    // R2 =  7.3*Ri
+    // R3 =  4.7*Ri
+    // Rf =  1.4*Ri
+    // R4 =  1.4*Ri
+    // R8 =  2.0*Ri
+    // RC =  2.8*Ri
+    //
+    //
+    // Approximate values for 1/Q can now be found as follows (assuming an
+    // ideal op-amp):
+    //
+    // res  feedback  input  -gain (1/Q)
+    // ---  --------  -----  ----------
+    // 0   Rf        Ri     Rf/Ri      = 1/(Ri*(1/Rf))      = 1/0.71
+    // 1   Rf|R1     Ri     (Rf|R1)/Ri = 1/(Ri*(1/Rf+1/R1)) = 1/0.78
+    // 2   Rf|R2     Ri     (Rf|R2)/Ri = 1/(Ri*(1/Rf+1/R2)) = 1/0.85
+    // 3   Rf|R3     Ri     (Rf|R3)/Ri = 1/(Ri*(1/Rf+1/R3)) = 1/0.92
+    // 4   Rf        R4     Rf/R4      = 1/(R4*(1/Rf))      = 1/1.00
+    // 5   Rf|R1     R4     (Rf|R1)/R4 = 1/(R4*(1/Rf+1/R1)) = 1/1.10
+    // 6   Rf|R2     R4     (Rf|R2)/R4 = 1/(R4*(1/Rf+1/R2)) = 1/1.20
+    // 7   Rf|R3     R4     (Rf|R3)/R4 = 1/(R4*(1/Rf+1/R3)) = 1/1.30
+    // 8   Rf        R8     Rf/R8      = 1/(R8*(1/Rf))      = 1/1.43
+    // 9   Rf|R1     R8     (Rf|R1)/R8 = 1/(R8*(1/Rf+1/R1)) = 1/1.56
+    // A   Rf|R2     R8     (Rf|R2)/R8 = 1/(R8*(1/Rf+1/R2)) = 1/1.70
+    // B   Rf|R3     R8     (Rf|R3)/R8 = 1/(R8*(1/Rf+1/R3)) = 1/1.86
+    // C   Rf        RC     Rf/RC      = 1/(RC*(1/Rf))      = 1/2.00
+    // D   Rf|R1     RC     (Rf|R1)/RC = 1/(RC*(1/Rf+1/R1)) = 1/2.18
+    // E   Rf|R2     RC     (Rf|R2)/RC = 1/(RC*(1/Rf+1/R2)) = 1/2.38
+    // F   Rf|R3     RC     (Rf|R3)/RC = 1/(RC*(1/Rf+1/R3)) = 1/2.60
+    //
+    //
+    // These data indicate that the following function for 1/Q has been
+    // modeled in the MOS 8580:
+    //
+    // 1/Q = 2^(1/2)*2^(-x/8) = 2^(1/2 - x/8) = 2^((4 - x)/8)
+    for (int n8 = 0; n8 < 16; n8++) {
+      int x = mf.ak;
+      for (int vi = 0; vi < (1 << 16); vi++) {
+        mf.resonance[n8][vi] = solve_gain_d(opamp, resGain[n8], vi, x, mf);
+      }
+    }
+  }
+
+  delete[] opamp;
+  built[m] = true;
+}
+
+
 // ----------------------------------------------------------------------------
 // Enable filter.
 // ----------------------------------------------------------------------------
@@ -673,6 +739,9 @@ void Filter::adjust_filter_bias(double dac_bias)
 // ----------------------------------------------------------------------------
 void Filter::set_chip_model(chip_model model)
 {
+  build_gain_tables(model);
+  tables_ready = true;
+
   sid_model = model;
   /* We initialize the state variables again just to make sure that
    * the earlier model didn't leave behind some foreign, unrecoverable
@@ -711,6 +780,8 @@ void Filter::reset()
   Vbp = Vbp_x = Vbp_vc = 0;
   Vlp = Vlp_x = Vlp_vc = 0;
 
+  rnd.reset();
+
   set_w0();
   set_sum_mix();
 }
@@ -637,6 +637,12 @@ protected:
   // DAC gate voltage
   int nVgt;
 
+  // The gain tables of sid_model are built (set_chip_model()).
+  bool tables_ready;
+
+  static void build_opamp(int m, unsigned int* voltages, opamp_t* opamp);
+  void build_gain_tables(chip_model model);
+
   //int solve_gain(opamp_t* opamp, int n, int vi_t, int& x, model_filter_t& mf);
   int solve_gain_d(opamp_t* opamp, double n, int vi_t, int& x, model_filter_t& mf);
   int solve_integrate_6581(int dt, int vi_t, int& x, int& vc, model_filter_t& mf);
@@ -657,11 +663,17 @@ private:
         int buffer[1024];
         mutable int index = 0;
     public:
+        // Fixed-seed LCG rather than rand(): every instance (on any thread)
+        // gets the same noise, so renders are repeatable.
         Randomnoise()
         {
-            for (int i=0; i<1024; i++)
-                buffer[i] = rand() % (1<<19);
+            unsigned int seed = 1;
+            for (int i=0; i<1024; i++) {
+                seed = seed * 1103515245u + 12345u;
+                buffer[i] = (seed >> 8) % (1<<19);
+            }
         }
+        void reset() { index = 0; }
         int getNoise() const { index = (index + 1) & 0x3ff; return buffer[index]; }
     };
 
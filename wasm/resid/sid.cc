@@ -27,6 +27,17 @@
 #include "sid.h"
 #include <cmath>
 #include <cassert>
+#include <mutex>
+#include <vector>
+
+#if RESID_SIMD && defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#elif RESID_SIMD && (defined(__SSE2__) || defined(_M_X64))
+#include <emmintrin.h>
+#define RESID_FIR_SSE2 1
+#elif RESID_SIMD && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 #ifndef round
 #define round(x) (x>=0.0?floor(x+0.5):ceil(x-0.5))
@@ -52,6 +63,72 @@ inline short amplify(int input, int scaleFactor)
     return clip((scaleFactor * input) / 2);
 }
 
+// ----------------------------------------------------------------------------
+// FIR convolution, sum(sample[j]*fir[j]) for j < n: the inner loop of the
+// resampling methods, run over fir_N (~2800 at 1 MHz / 44.1 kHz) taps per
+// output sample. The SIMD paths take eight 16-bit pairs at a time into four
+// 32-bit sums; the integer sums are the same in any order, so the output is
+// identical to the scalar loop's.
+// ----------------------------------------------------------------------------
+inline int fir_convolve(const short* sample, const short* fir, int n)
+{
+  int j = 0;
+  int v = 0;
+#if RESID_SIMD && defined(__wasm_simd128__)
+  v128_t acc0 = wasm_i32x4_splat(0);
+  v128_t acc1 = wasm_i32x4_splat(0);
+  for (; j + 16 <= n; j += 16) {
+    acc0 = wasm_i32x4_add(acc0, wasm_i32x4_dot_i16x8(wasm_v128_load(sample + j),
+                                                     wasm_v128_load(fir + j)));
+    acc1 = wasm_i32x4_add(acc1, wasm_i32x4_dot_i16x8(wasm_v128_load(sample + j + 8),
+                                                     wasm_v128_load(fir + j + 8)));
+  }
+  for (; j + 8 <= n; j += 8) {
+    acc0 = wasm_i32x4_add(acc0, wasm_i32x4_dot_i16x8(wasm_v128_load(sample + j),
+                                                     wasm_v128_load(fir + j)));
+  }
+  acc0 = wasm_i32x4_add(acc0, acc1);
+  v = wasm_i32x4_extract_lane(acc0, 0) + wasm_i32x4_extract_lane(acc0, 1) +
+      wasm_i32x4_extract_lane(acc0, 2) + wasm_i32x4_extract_lane(acc0, 3);
+#elif defined(RESID_FIR_SSE2)
+  __m128i acc0 = _mm_setzero_si128();
+  __m128i acc1 = _mm_setzero_si128();
+  for (; j + 16 <= n; j += 16) {
+    acc0 = _mm_add_epi32(acc0, _mm_madd_epi16(
+      _mm_loadu_si128((const __m128i*)(sample + j)),
+      _mm_loadu_si128((const __m128i*)(fir + j))));
+    acc1 = _mm_add_epi32(acc1, _mm_madd_epi16(
+      _mm_loadu_si128((const __m128i*)(sample + j + 8)),
+      _mm_loadu_si128((const __m128i*)(fir + j + 8))));
+  }
+  for (; j + 8 <= n; j += 8) {
+    acc0 = _mm_add_epi32(acc0, _mm_madd_epi16(
+      _mm_loadu_si128((const __m128i*)(sample + j)),
+      _mm_loadu_si128((const __m128i*)(fir + j))));
+  }
+  acc0 = _mm_add_epi32(acc0, acc1);
+  acc0 = _mm_add_epi32(acc0, _mm_shuffle_epi32(acc0, _MM_SHUFFLE(1, 0, 3, 2)));
+  acc0 = _mm_add_epi32(acc0, _mm_shuffle_epi32(acc0, _MM_SHUFFLE(2, 3, 0, 1)));
+  v = _mm_cvtsi128_si32(acc0);
+#elif RESID_SIMD && defined(__ARM_NEON)
+  int32x4_t acc0 = vdupq_n_s32(0);
+  int32x4_t acc1 = vdupq_n_s32(0);
+  for (; j + 8 <= n; j += 8) {
+    int16x8_t s = vld1q_s16(sample + j);
+    int16x8_t f = vld1q_s16(fir + j);
+    acc0 = vmlal_s16(acc0, vget_low_s16(s), vget_low_s16(f));
+    acc1 = vmlal_s16(acc1, vget_high_s16(s), vget_high_s16(f));
+  }
+  acc0 = vaddq_s32(acc0, acc1);
+  v = vgetq_lane_s32(acc0, 0) + vgetq_lane_s32(acc0, 1) +
+      vgetq_lane_s32(acc0, 2) + vgetq_lane_s32(acc0, 3);
+#endif
+  for (; j < n; j++) {
+    v += sample[j]*fir[j];
+  }
+  return v;
+}
+
 // ----------------------------------------------------------------------------
 // Constructor.
 // ----------------------------------------------------------------------------
@@ -62,9 +139,6 @@ SID::SID()
   fir = 0;
   fir_N = 0;
   fir_RES = 0;
-  fir_beta = 0;
-  fir_f_cycles_per_sample = 0;
-  fir_filter_scale = 0;
 
   sid_model = MOS6581;
   voice[0].set_sync_source(&voice[2]);
@@ -91,7 +165,7 @@ SID::SID()
 SID::~SID()
 {
   delete[] sample;
-  delete[] fir;
+  release_fir(fir);
 }
 
 
@@ -534,6 +608,144 @@ double SID::I0(double x)
 }
 
 
+// ----------------------------------------------------------------------------
+// Shared FIR tables.
+// Chips resampling with the same parameters use the same (read-only) table,
+// so tables are cached here and reference counted instead of being rebuilt
+// for every chip on every set_sampling_parameters() call. A table nobody
+// uses any more is kept until a table with other parameters is built, so
+// switching the sampling method away and back, or recreating the chips for
+// the next tune, finds it still there.
+// ----------------------------------------------------------------------------
+namespace {
+
+struct FIRTable
+{
+  double clock_freq;
+  sampling_method method;
+  double sample_freq;
+  double pass_freq;
+  double filter_scale;
+  int N;
+  int RES;
+  short* table;
+  int refs;
+};
+
+std::mutex fir_cache_lock;
+std::vector<FIRTable> fir_cache;
+
+}
+
+const short* SID::acquire_fir(double clock_freq, sampling_method method,
+                              double sample_freq, double pass_freq,
+                              double filter_scale, int& N_out, int& RES_out)
+{
+  std::lock_guard<std::mutex> lock(fir_cache_lock);
+
+  for (size_t i = 0; i < fir_cache.size(); i++) {
+    FIRTable& t = fir_cache[i];
+    if (t.clock_freq == clock_freq && t.method == method &&
+        t.sample_freq == sample_freq && t.pass_freq == pass_freq &&
+        t.filter_scale == filter_scale) {
+      t.refs++;
+      N_out = t.N;
+      RES_out = t.RES;
+      return t.table;
+    }
+  }
+
+  // Drop unused tables before building a new one.
+  for (size_t i = fir_cache.size(); i-- > 0; ) {
+    if (fir_cache[i].refs == 0) {
+      delete[] fir_cache[i].table;
+      fir_cache.erase(fir_cache.begin() + i);
+    }
+  }
+
+  const double pi = 3.1415926535897932385;
+
+  // 16 bits -> -96dB stopband attenuation.
+  const double A = -20*log10(1.0/(1 << 16));
+  // A fraction of the bandwidth is allocated to the transition band,
+  double dw = (1 - 2*pass_freq/sample_freq)*pi*2;
+  // The cutoff frequency is midway through the transition band (nyquist)
+  double wc = pi;
+
+  // For calculation of beta and N see the reference for the kaiserord
+  // function in the MATLAB Signal Processing Toolbox:
+  // http://www.mathworks.com/access/helpdesk/help/toolbox/signal/kaiserord.html
+  const double beta = 0.1102*(A - 8.7);
+  const double I0beta = I0(beta);
+
+  // The filter order will maximally be 124 with the current constraints.
+  // N >= (96.33 - 7.95)/(2.285*0.1*pi) -> N >= 123
+  // The filter order is equal to the number of zero crossings, i.e.
+  // it should be an even number (sinc is symmetric about x = 0).
+  int N = int((A - 7.95)/(2.285*dw) + 0.5);
+  N += N & 1;
+
+  double f_samples_per_cycle = sample_freq/clock_freq;
+  double f_cycles_per_sample = clock_freq/sample_freq;
+
+  // The filter length is equal to the filter order + 1.
+  // The filter length must be an odd number (sinc is symmetric about x = 0).
+  int fir_N = int(N*f_cycles_per_sample) + 1;
+  fir_N |= 1;
+
+  // Check whether the sample ring buffer would overflow.
+  assert(fir_N < RINGSIZE);
+
+  // We clamp the filter table resolution to 2^n, making the fixed point
+  // sample_offset a whole multiple of the filter table resolution.
+  int res = method == SAMPLE_RESAMPLE ?
+    FIR_RES : FIR_RES_FASTMEM;
+  int n = (int)ceil(log(res/f_cycles_per_sample)/log(2.0f));
+  int fir_RES = 1 << n;
+
+  // Allocate memory for FIR tables.
+  short* fir = new short[fir_N*fir_RES];
+
+  // Calculate fir_RES FIR tables for linear interpolation.
+  for (int i = 0; i < fir_RES; i++) {
+    int fir_offset = i*fir_N + fir_N/2;
+    double j_offset = double(i)/fir_RES;
+    // Calculate FIR table. This is the sinc function, weighted by the
+    // Kaiser window.
+    for (int j = -fir_N/2; j <= fir_N/2; j++) {
+      double jx = j - j_offset;
+      double wt = wc*jx/f_cycles_per_sample;
+      double temp = jx/(fir_N/2);
+      double Kaiser = fabs(temp) <= 1 ? I0(beta*sqrt(1 - temp*temp))/I0beta : 0;
+      double sincwt = fabs(wt) >= 1e-6 ? sin(wt)/wt : 1;
+      double val = (1 << FIR_SHIFT)*filter_scale*f_samples_per_cycle*wc/pi*sincwt*Kaiser;
+      fir[fir_offset + j] = (short)round(val);
+    }
+  }
+
+  FIRTable t = { clock_freq, method, sample_freq, pass_freq, filter_scale,
+                 fir_N, fir_RES, fir, 1 };
+  fir_cache.push_back(t);
+  N_out = fir_N;
+  RES_out = fir_RES;
+  return fir;
+}
+
+void SID::release_fir(const short* table)
+{
+  if (!table) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(fir_cache_lock);
+  for (size_t i = 0; i < fir_cache.size(); i++) {
+    if (fir_cache[i].table == table) {
+      fir_cache[i].refs--;
+      return;
+    }
+  }
+}
+
+
 // ----------------------------------------------------------------------------
 // Setting of SID sampling parameters.
 //
@@ -601,7 +813,7 @@ bool SID::set_sampling_parameters(double clock_freq, sampling_method method,
   if (method != SAMPLE_RESAMPLE && method != SAMPLE_RESAMPLE_FASTMEM)
   {
     delete[] sample;
-    delete[] fir;
+    release_fir(fir);
     sample = 0;
     fir = 0;
     return true;
@@ -617,78 +829,10 @@ bool SID::set_sampling_parameters(double clock_freq, sampling_method method,
   }
   sample_index = 0;
 
-  const double pi = 3.1415926535897932385;
-
-  // 16 bits -> -96dB stopband attenuation.
-  const double A = -20*log10(1.0/(1 << 16));
-  // A fraction of the bandwidth is allocated to the transition band,
-  double dw = (1 - 2*pass_freq/sample_freq)*pi*2;
-  // The cutoff frequency is midway through the transition band (nyquist)
-  double wc = pi;
-
-  // For calculation of beta and N see the reference for the kaiserord
-  // function in the MATLAB Signal Processing Toolbox:
-  // http://www.mathworks.com/access/helpdesk/help/toolbox/signal/kaiserord.html
-  const double beta = 0.1102*(A - 8.7);
-  const double I0beta = I0(beta);
-
-  // The filter order will maximally be 124 with the current constraints.
-  // N >= (96.33 - 7.95)/(2.285*0.1*pi) -> N >= 123
-  // The filter order is equal to the number of zero crossings, i.e.
-  // it should be an even number (sinc is symmetric about x = 0).
-  int N = int((A - 7.95)/(2.285*dw) + 0.5);
-  N += N & 1;
-
-  double f_samples_per_cycle = sample_freq/clock_freq;
-  double f_cycles_per_sample = clock_freq/sample_freq;
-
-  // The filter length is equal to the filter order + 1.
-  // The filter length must be an odd number (sinc is symmetric about x = 0).
-  int fir_N_new = int(N*f_cycles_per_sample) + 1;
-  fir_N_new |= 1;
-
-  // Check whether the sample ring buffer would overflow.
-  assert(fir_N_new < RINGSIZE);
-
-  // We clamp the filter table resolution to 2^n, making the fixed point
-  // sample_offset a whole multiple of the filter table resolution.
-  int res = method == SAMPLE_RESAMPLE ?
-    FIR_RES : FIR_RES_FASTMEM;
-  int n = (int)ceil(log(res/f_cycles_per_sample)/log(2.0f));
-  int fir_RES_new = 1 << n;
-
-  /* Determine if we need to recalculate table, or whether we can reuse earlier cached copy.
-   * This pays off on slow hardware such as current Android devices.
-   */
-  if (fir && fir_RES_new == fir_RES && fir_N_new == fir_N && beta == fir_beta && f_cycles_per_sample == fir_f_cycles_per_sample && fir_filter_scale == filter_scale) {
-      return true;
-  }
-  fir_RES = fir_RES_new;
-  fir_N = fir_N_new;
-  fir_beta = beta;
-  fir_f_cycles_per_sample = f_cycles_per_sample;
-  fir_filter_scale = filter_scale;
-
-  // Allocate memory for FIR tables.
-  delete[] fir;
-  fir = new short[fir_N*fir_RES];
-
-  // Calculate fir_RES FIR tables for linear interpolation.
-  for (int i = 0; i < fir_RES; i++) {
-    int fir_offset = i*fir_N + fir_N/2;
-    double j_offset = double(i)/fir_RES;
-    // Calculate FIR table. This is the sinc function, weighted by the
-    // Kaiser window.
-    for (int j = -fir_N/2; j <= fir_N/2; j++) {
-      double jx = j - j_offset;
-      double wt = wc*jx/f_cycles_per_sample;
-      double temp = jx/(fir_N/2);
-      double Kaiser = fabs(temp) <= 1 ? I0(beta*sqrt(1 - temp*temp))/I0beta : 0;
-      double sincwt = fabs(wt) >= 1e-6 ? sin(wt)/wt : 1;
-      double val = (1 << FIR_SHIFT)*filter_scale*f_samples_per_cycle*wc/pi*sincwt*Kaiser;
-      fir[fir_offset + j] = (short)round(val);
-    }
-  }
+  const short* table = acquire_fir(clock_freq, method, sample_freq, pass_freq,
+                                   filter_scale, fir_N, fir_RES);
+  release_fir(fir);
+  fir = table;
 
   return true;
 }
@@ -720,6 +864,11 @@ void SID::clock(cycle_count delta_t)
 {
   int i;
 
+  // A chip clocked without set_chip_model() builds its filter tables now.
+  if (unlikely(!filter.tables_ready)) {
+    filter.set_chip_model(sid_model);
+  }
+
   // Pipelined writes on the MOS8580.
   if (unlikely(write_pipeline) && likely(delta_t > 0)) {
     // Step one cycle by a recursive call to ourselves.
@@ -822,6 +971,11 @@ void SID::clock(cycle_count delta_t)
 // ----------------------------------------------------------------------------
 int SID::clock(cycle_count& delta_t, short* buf, int n, int interleave)
 {
+  // A chip clocked without set_chip_model() builds its filter tables now.
+  if (unlikely(!filter.tables_ready)) {
+    filter.set_chip_model(sid_model);
+  }
+
   switch (sampling) {
   default:
   case SAMPLE_FAST:
@@ -975,14 +1129,11 @@ int SID::clock_resample(cycle_count& delta_t, short* buf, int n, int interleave)
 
     int fir_offset = sample_offset*fir_RES >> FIXP_SHIFT;
     int fir_offset_rmd = sample_offset*fir_RES & FIXP_MASK;
-    short* fir_start = fir + fir_offset*fir_N;
+    const short* fir_start = fir + fir_offset*fir_N;
     short* sample_start = sample + sample_index - fir_N - 1 + RINGSIZE;
 
     // Convolution with filter impulse response.
-    int v1 = 0;
-    for (int j = 0; j < fir_N; j++) {
-      v1 += sample_start[j]*fir_start[j];
-    }
+    int v1 = fir_convolve(sample_start, fir_start, fir_N);
 
     // Use next FIR table, wrap around to first FIR table using
     // next sample.
@@ -993,10 +1144,7 @@ int SID::clock_resample(cycle_count& delta_t, short* buf, int n, int interleave)
     fir_start = fir + fir_offset*fir_N;
 
     // Convolution with filter impulse response.
-    int v2 = 0;
-    for (int k = 0; k < fir_N; k++) {
-      v2 += sample_start[k]*fir_start[k];
-    }
+    int v2 = fir_convolve(sample_start, fir_start, fir_N);
 
     // Linear interpolation.
     // fir_offset_rmd is equal for all samples, it can thus be factorized out:
@@ -1041,14 +1189,11 @@ int SID::clock_resample_fastmem(cycle_count& delta_t, short* buf, int n, int int
     sample_offset = next_sample_offset & FIXP_MASK;
 
     int fir_offset = sample_offset*fir_RES >> FIXP_SHIFT;
-    short* fir_start = fir + fir_offset*fir_N;
+    const short* fir_start = fir + fir_offset*fir_N;
     short* sample_start = sample + sample_index - fir_N + RINGSIZE;
 
     // Convolution with filter impulse response.
-    int v = 0;
-    for (int j = 0; j < fir_N; j++) {
-      v += sample_start[j]*fir_start[j];
-    }
+    int v = fir_convolve(sample_start, fir_start, fir_N);
 
     v >>= FIR_SHIFT;
 
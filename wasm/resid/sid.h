@@ -101,10 +101,23 @@ public:
   // 16-bit output (AUDIO OUT).
   int output();
 
+  // Amplitude modulated output of one voice (20 bits), before the filter.
+  int voice_output(int i);
+
+  // Envelope level of one voice (8 bits), as ENV3 reads for voice 3.
+  reg8 envelope_level(int i);
+
+  // The model chosen by set_chip_model.
+  chip_model get_chip_model();
+
   void debugoutput(void);
 
  protected:
   static double I0(double x);
+  static const short* acquire_fir(double clock_freq, sampling_method method,
+                                  double sample_freq, double pass_freq,
+                                  double filter_scale, int& N, int& RES);
+  static void release_fir(const short* table);
   int clock_fast(cycle_count& delta_t, short* buf, int n, int interleave);
   int clock_interpolate(cycle_count& delta_t, short* buf, int n, int interleave);
   int clock_resample(cycle_count& delta_t, short* buf, int n, int interleave);
@@ -162,15 +175,13 @@ public:
   short sample_prev, sample_now;
   int fir_N;
   int fir_RES;
-  double fir_beta;
-  double fir_f_cycles_per_sample;
-  double fir_filter_scale;
 
   // Ring buffer with overflow for contiguous storage of RINGSIZE samples.
   short* sample;
 
-  // FIR_RES filter tables (FIR_N*FIR_RES).
-  short* fir;
+  // FIR_RES filter tables (FIR_N*FIR_RES), shared between SID instances
+  // with the same sampling parameters (see acquire_fir()).
+  const short* fir;
 
   bool raw_debug_output; // FIXME: should be private?
 };
@@ -194,6 +205,36 @@ int SID::output()
 }
 
 
+// ----------------------------------------------------------------------------
+// Voice output, before the filter.
+// ----------------------------------------------------------------------------
+RESID_INLINE
+int SID::voice_output(int i)
+{
+  return voice[i].output();
+}
+
+
+// ----------------------------------------------------------------------------
+// Envelope level, without the side effects of a register read.
+// ----------------------------------------------------------------------------
+RESID_INLINE
+reg8 SID::envelope_level(int i)
+{
+  return voice[i].envelope.readENV();
+}
+
+
+// ----------------------------------------------------------------------------
+// Chip model.
+// ----------------------------------------------------------------------------
+RESID_INLINE
+chip_model SID::get_chip_model()
+{
+  return sid_model;
+}
+
+
 // ----------------------------------------------------------------------------
 // SID clocking - 1 cycle.
 // ----------------------------------------------------------------------------
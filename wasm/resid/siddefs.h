@@ -11,6 +11,12 @@
 
 #define NEW_8580_FILTER 1
 
+// SIMD FIR convolution for resampling: WASM SIMD128, SSE2 or NEON, whichever
+// the compiler targets. Define as 0 to build the scalar loop everywhere.
+#ifndef RESID_SIMD
+#define RESID_SIMD 1
+#endif
+
 // Compiler specifics.
 #define HAVE_BOOL 1
 #define HAVE_BUILTIN_EXPECT 1
@@ -2,14 +2,39 @@
 // Provides cycle-accurate SID emulation via reSID library
 // with a lightweight 6510 CPU for running SID play routines.
 //
-// Compile together with reSID sources via Emscripten.
+// Compile together with reSID sources via Emscripten, or natively for the
+// SIDRender command-line tool.
 
+#ifdef __EMSCRIPTEN__
 #include <emscripten/emscripten.h>
+#define ENGINE_STATE static
+static double now_ms() { return emscripten_get_now(); }
+#else
+// Native builds render on several threads, one engine per thread.
+#define EMSCRIPTEN_KEEPALIVE
+#define ENGINE_STATE static thread_local
+#include <chrono>
+static double now_ms() {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
 #include <cstdint>
 #include <cstring>
 #include <cmath>
+#include <climits>
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <unordered_map>
+#include <vector>
 #include "resid/sid.h"
 
+#ifdef __wasm_simd128__
+#include <wasm_simd128.h>
+#endif
+
 extern "C" {
 
 // ---- Constants ----
@@ -17,7 +42,24 @@ static const double PAL_CLOCK  = 985248.0;
 static const double NTSC_CLOCK = 1022730.0;
 static const int PAL_CYCLES_PER_FRAME  = 19656;
 static const int NTSC_CYCLES_PER_FRAME = 17095;
+static const int PAL_CYCLES_PER_LINE  = 63;    // raster lines: 312 PAL, 263 NTSC
+static const int NTSC_CYCLES_PER_LINE = 65;
 static const int MAX_SID_CHIPS = 3;
+static const int MAX_QUEUED_WRITES = 5120;  // per frame (a PAL frame of back-to-back stores fits); overflow writes apply immediately
+static const int RENDER_BLOCK = 4096;       // samples per audio_render step
+static const double SEEK_DEFAULT_INTERVAL = 1.0;  // seconds between seek snapshots
+static const double SEEK_SETTLE = 0.25;           // seconds clocked in full before a seek target
+static const size_t SEEK_MAX_BYTES = 8 << 20;     // RAM kept for seek snapshots, all instances together
+static const int INIT_CACHE_ENTRIES = 32;         // post-init snapshots kept (LRU)
+static const int INIT_LOG_MAX = 16384;            // SID accesses an init may make and still be cached
+static const double DUMP_DEFAULT_SECONDS = 600.0; // longest register dump captured without a loop
+static const double GOVERNOR_DOWN_LOAD = 0.6;     // render time / audio time that steps quality down
+static const double GOVERNOR_UP_LOAD = 0.12;      // ... and, sustained, back up
+static const double GOVERNOR_UP_AFTER = 10.0;     // seconds of audio below GOVERNOR_UP_LOAD before a step up
+static const double GOVERNOR_HOLD = 2.0;          // seconds of audio after a step before the next
+static const double GOVERNOR_SMOOTHING = 0.5;     // seconds of audio the load average spans
+static const double SILENCE_DEFAULT_SECONDS = 5.0; // quiet output this long is reported as silent
+static const int SILENCE_RANGE = 64;              // peak-to-peak (16-bit) a block may swing and be quiet
 
 // ---- CPU flags ----
 #define FLAG_C 0x01
@@ -29,8 +71,127 @@ static const int MAX_SID_CHIPS = 3;
 #define FLAG_V 0x40
 #define FLAG_N 0x80
 
+// ---- CIA 1 timers ----
+// Timer A and B of CIA 1, which pace the play calls of CIA-speed tunes.
+// They are event-driven: a running timer keeps the frame cycle of its next
+// underflow rather than counting down every cycle.
+struct CIATimer {
+    uint16_t latch;
+    uint16_t counter;          // while stopped
+    int      underflow;        // while running: frame cycle of the next underflow
+    uint8_t  control;          // CRA/CRB: bit 0 start, bit 3 one-shot, bits 5-6 input (B)
+};
+
+struct CIAState {
+    CIATimer timer[2];
+    uint8_t  irqMask;          // ICR: bit 0 timer A, bit 1 timer B
+    uint8_t  flags;            // ICR interrupt data, latched by underflows (mini-C64 only)
+};
+
+// ---- Mini-C64 ----
+// What RSID tunes get besides CIA 1 (see "Mini-C64 I/O"): CIA 2, whose
+// timers raise NMIs, and the VIC's raster counter and raster interrupt.
+struct MiniC64 {
+    CIAState cia2;
+    uint16_t rasterCompare;    // $D011 bit 7 and $D012 as written
+    uint8_t  vicIrqFlags;      // $D019: bit 0 raster compare
+    uint8_t  vicIrqMask;       // $D01A
+    int      rasterEvent;      // frame cycle of the next raster compare match, INT_MAX: none
+    int      nextEvent;        // earliest raster match or timer underflow; 0: work it out again
+    int      carry;            // cycles the last frame's final instruction ran into this one
+    bool     nmiLine;          // CIA 2 interrupt output (NMI is edge-triggered)
+    bool     nmiPending;
+};
+
+// ---- Register dump position ----
+struct DumpCursor {
+    uint32_t offset;           // next record
+    uint32_t frame;            // next frame
+    uint32_t run;              // frames left in the current empty run
+    int      length;           // cycles per frame, as last set
+};
+
+// ---- Playback statistics ----
+// Running counters, kept whether or not anyone reads them: each is a plain
+// add or compare on a path that runs at most once per play call.
+struct EngineCounters {
+    uint64_t emulatedCycles;   // cycles clocked through the SIDs for output
+    uint64_t samples;          // output samples rendered
+    uint64_t blocks;           // render calls
+    uint64_t playCalls;
+    uint64_t playCycles;       // summed over playCalls
+    uint32_t playCyclesMax;
+    uint64_t guardTrips;       // subroutine calls cut off by cpu_jsr's maxCycles
+    uint64_t guardCycles;      // cycles those calls ran before being cut off
+    uint64_t stallTrips;       // zero-progress iterations caught in render_chips
+    double   cpuMs;            // wall time in play calls while rendering
+    double   sidMs;            // ... and in the rest of the render (reSID)
+    double   blockCpuMs;       // the same for the last render call
+    double   blockSidMs;
+    int      blockSamples;
+};
+
+// What audio_get_stats fills in: all doubles, so JS can read it as a
+// Float64Array of AUDIO_STATS_FIELDS.
+struct AudioStats {
+    double emulatedCycles;
+    double samples;
+    double blocks;
+    double playCalls;
+    double playCyclesAvg;
+    double playCyclesMax;
+    double guardTrips;
+    double guardCycles;
+    double stallTrips;
+    double cpuMs;
+    double sidMs;
+    double blockCpuMs;
+    double blockSidMs;
+    double blockSamples;
+};
+static const int AUDIO_STATS_FIELDS = sizeof(AudioStats) / sizeof(double);
+
+// ---- Seek snapshot ----
+struct SeekSnapshot {
+    bool     valid;
+    bool     exact;            // SIDs were clocked up to it; sidState holds them
+    uint64_t totalCycles;
+    int      remainingCycles;
+    uint16_t pc;
+    uint8_t  sp, a, x, y, st;
+    CIAState cia;
+    MiniC64  c64;
+    DumpCursor dumpCursor;
+    std::vector<uint8_t> pages;  // page number + 256 bytes, per page differing from seekBase
+    reSID::SID::State sidState[MAX_SID_CHIPS];
+};
+
+// ---- Init snapshot ----
+// A SID register access made by an init routine. Replaying them onto freshly
+// reset chips rebuilds the chips' post-init state exactly.
+struct InitSIDAccess {
+    uint8_t chip;
+    uint8_t reg;
+    uint8_t value;
+    bool    write;
+};
+
+struct InitSnapshot {
+    uint64_t key;              // tune hash, subtune and chip model
+    uint64_t lastUse;
+    uint16_t pc;
+    uint8_t  sp, a, x, y, st;
+    int      cyclesPerFrame;
+    uint16_t playAddress;
+    CIAState cia;
+    std::vector<uint8_t> pages;  // page number + 256 bytes, per page differing from the loaded image
+    std::vector<InitSIDAccess> sidLog;
+};
+
 // ---- Playback state ----
-static struct {
+// One engine instance: RAM, CPU, chips and playback settings. reSID's model
+// tables and the opcode table are static and shared by all instances.
+struct EngineState {
     // 6510 CPU registers
     uint16_t pc;
     uint8_t  sp, a, x, y, st;
@@ -54,6 +215,9 @@ static struct {
     uint16_t flags;        // v2+ flags field
     uint8_t  secondSIDAddr;
     uint8_t  thirdSIDAddr;
+    uint16_t headerPlayAddress;    // 0 = derived from the IRQ vectors after init
+    uint64_t tuneHash;             // of the whole file
+    std::vector<uint8_t> loadImage;  // RAM right after loading, before any init
 
     // Playback config
     double   clockFreq;
@@ -65,51 +229,431 @@ static struct {
 
     // Frame-level playback
     int      remainingCycles;  // cycles left in current frame
+    bool     ciaSpeed;         // the subtune's play calls follow the CIA timers
+    CIAState cia;
+    bool     machine;          // RSID: the tune runs on the mini-C64, not by play calls
+    MiniC64  c64;
+    int      cpuCycle;         // frame cycle of the instruction being run
     bool     playRoutineActive;
     uint64_t totalCycles;      // total cycles since play started
     int      chipModel;        // 6581 or 8580
-} S;
+
+    // SID writes made by the current play call, stamped with the cycle
+    // (from the start of the frame) on which they occur. They are applied
+    // while reSID is clocked across the frame, so mid-frame writes (hard
+    // restart, PWM sweeps, $D418 digis) land where the tune put them.
+    struct QueuedWrite {
+        int     cycle;
+        uint8_t chip;
+        uint8_t reg;
+        uint8_t value;
+    };
+    QueuedWrite writeQueue[MAX_QUEUED_WRITES];
+    int      writeCount;
+    int      writeNext;        // first write not yet applied
+    bool     deferWrites;      // set while the play routine runs
+    int      frameCycles;      // length of the frame the queue belongs to
+
+    // Per-chip render buffers (grown to the largest request) and stereo
+    // positions for the float output path.
+    std::vector<int16_t> chipBuffer[MAX_SID_CHIPS];
+    float    chipPan[MAX_SID_CHIPS];
+    float    chipGain[MAX_SID_CHIPS];   // 0..1, applied by both output paths
+
+    // Offline WAV rendering (audio_render_begin / audio_render)
+    bool     renderActive;
+    bool     renderHeaderPending;
+    int      renderFormat;
+    uint32_t renderTotalFrames;
+    uint32_t renderDoneFrames;
+    uint32_t renderFadeFrames;
+    std::vector<float>   renderLeft, renderRight;
+    std::vector<int16_t> renderMono;
+
+    // Seek index: one snapshot per seek interval, taken at the first frame
+    // boundary in it (see audio_seek).
+    std::vector<SeekSnapshot> seekSlots;
+    std::vector<uint8_t> seekBase;  // RAM right after init
+    uint64_t seekOrigin;           // totalCycles of slot 0
+    uint64_t seekInterval;         // cycles per slot
+    size_t   seekBytes;
+    bool     cpuOnly;              // fast-forward: SIDs neither clocked nor accessed
+
+    // Voice taps (audio_set_voice_taps): pre-filter output of every voice,
+    // captured every tapDecimation output samples while rendering.
+    float*   tapBuffer;            // planar, (chip * 3 + voice) * tapCapacity
+    int      tapCapacity;
+    int      tapDecimation;
+    int      tapPhase;             // samples since the last tap
+    int      tapCount;             // taps written by the last render
+
+    // Register stream (audio_set_register_stream): every chip's registers
+    // as each play frame starts, with the output sample index it starts at.
+    uint8_t* regFrames;            // REGISTER_FRAME_BYTES per frame
+    double*  regFrameSamples;
+    int      regCapacity;
+    int      regCount;             // frames written by the last render
+    uint64_t outputSamples;        // samples rendered since audio_init
+
+    // Sampling method and the quality governor (audio_set_quality_governor)
+    int      samplingMethod;       // in effect: 0 fast, 1 interpolate, 2 resample
+    int      methodCeiling;        // as last chosen by audio_set_sampling_method
+    bool     governorOn;
+    double   renderLoad;           // smoothed render time / audio time, live output
+    double   governorHold;         // seconds of audio before the next step
+    double   governorCalm;         // seconds of audio spent below GOVERNOR_UP_LOAD
+
+    // Register dump playback (audio_load_sid given a dump): the dump's
+    // recorded writes stand in for the play calls
+    std::vector<uint8_t> dump;     // empty: the tune's own code runs
+    DumpCursor dumpCursor;
+    uint32_t dumpFrames;
+    uint32_t dumpLoopFrame;        // DUMP_NO_LOOP: none
+    uint32_t dumpLoopOffset;
+    uint32_t dumpInitWrites;
+    std::vector<uint8_t> dumpCapture;  // made by audio_dump_capture
+
+    EngineCounters stats;          // audio_get_stats
+
+    // End-of-tune detection (audio_set_silence_detection)
+    double   silenceSeconds;       // quiet output this long counts as silent
+    bool     silenceSkip;          // hold the output instead of clocking reSID when idle
+    uint64_t quietSamples;         // output samples quiet in a row
+    bool     skipping;             // reSID not being clocked (see update_skipping)
+    double   skipPhase;            // cycles clocked towards the next held sample
+    uint8_t  skipVolume[MAX_SID_CHIPS];  // $D418 of each chip when skipping began
+    int16_t  lastSample[MAX_SID_CHIPS];  // each chip's latest output sample
+
+    // Post-init snapshots (see audio_set_subtune), kept across tune loads
+    std::vector<InitSnapshot> initCache;
+    std::vector<InitSIDAccess> initLog;
+    bool     initLogging;          // init running: log SID accesses
+    uint64_t initCacheClock;
+};
+
+// Instances by handle (0 = the default one, made by audio_init) and the one
+// every call acts on (audio_select).
+ENGINE_STATE std::vector<std::unique_ptr<EngineState>> g_engines;
+ENGINE_STATE EngineState* g_engine = nullptr;
+#define S (*g_engine)
+
+// ---- CIA 1 timers ----
+// Only what decides when play calls happen is modelled: the latches, start,
+// one-shot and force-load control bits and the interrupt mask. Timer B
+// counting timer A underflows or CNT never underflows here. Register
+// accesses are timed to the start of the instruction making them.
+
+// As the Kernal leaves CIA 1: timer A running continuously from the latch
+// at $DC04/$DC05 with its interrupt enabled, timer B stopped.
+static void cia_reset() {
+    CIATimer& a = S.cia.timer[0];
+    a.latch = S.memory[0xDC04] | (S.memory[0xDC05] << 8);
+    a.counter = a.latch;
+    a.control = 0x01;
+    a.underflow = a.latch + 1;
+    CIATimer& b = S.cia.timer[1];
+    b.latch = b.counter = 0xFFFF;
+    b.control = 0x00;
+    b.underflow = 0;
+    S.cia.irqMask = 0x01;
+    S.cia.flags = 0;
+}
+
+static inline bool cia_running(const CIATimer& t) {
+    return (t.control & 0x61) == 0x01;  // started, counting clock cycles
+}
+
+// The timer's count at frame cycle `cycle`.
+static uint16_t cia_count(const CIATimer& t, int cycle) {
+    if (!cia_running(t)) return t.counter;
+    int left = t.underflow - 1 - cycle;
+    if (left >= 0) return (uint16_t)left;
+    if (t.control & 0x08) return t.latch;  // one-shot: stopped at the underflow
+    return (uint16_t)(t.latch - (-left - 1) % (t.latch + 1));
+}
+
+static void cia_write(CIAState& cia, uint8_t reg, uint8_t val, int cycle) {
+    if (reg == 0x0D) {
+        if (val & 0x80) cia.irqMask |= val & 0x1F;
+        else            cia.irqMask &= ~val;
+        return;
+    }
+    if (reg < 0x04 || (reg > 0x07 && reg < 0x0E)) return;
+
+    CIATimer& t = cia.timer[reg < 0x0E ? (reg - 0x04) >> 1 : reg - 0x0E];
+    if (reg < 0x0E) {
+        if (reg & 1) {
+            t.latch = (t.latch & 0x00FF) | (val << 8);
+            if (!(t.control & 0x01)) t.counter = t.latch;  // a stopped timer loads on the high byte
+        } else {
+            t.latch = (t.latch & 0xFF00) | val;
+        }
+        return;
+    }
+
+    t.counter = cia_count(t, cycle);
+    t.control = val & ~0x10;
+    if (val & 0x10) t.counter = t.latch;  // force load
+    if (cia_running(t)) t.underflow = cycle + t.counter + 1;
+}
+
+// Play calls start right after init, as if the timers had just reloaded.
+static void cia_start() {
+    for (CIATimer& t : S.cia.timer) {
+        t.underflow = t.latch + 1;
+    }
+}
+
+// Frame cycle of the next underflow that raises an interrupt, or INT_MAX.
+static int cia_next_irq() {
+    int next = INT_MAX;
+    for (int i = 0; i < 2; i++) {
+        const CIATimer& t = S.cia.timer[i];
+        if ((S.cia.irqMask & (1 << i)) && cia_running(t)) next = std::min(next, t.underflow);
+    }
+    return next;
+}
+
+// Move the timers on to a frame starting `cycles` later, reloading those
+// that underflow on the way (one-shot timers stop instead).
+static void cia_advance(CIAState& cia, int cycles) {
+    for (CIATimer& t : cia.timer) {
+        if (!cia_running(t)) continue;
+        t.underflow -= cycles;
+        if (t.underflow > 0) continue;
+        if (t.control & 0x08) {
+            t.control &= ~0x01;
+            t.counter = t.latch;
+        } else {
+            int period = t.latch + 1;
+            t.underflow += (-t.underflow / period + 1) * period;
+        }
+    }
+}
+
+// ---- Mini-C64 I/O ----
+// RSID tunes expect a real C64: they install their own interrupts and may
+// never return from init, playing from a main loop, raster interrupts or
+// CIA 2 NMIs (sample players). For them (S.machine) the CPU runs
+// continuously, and an event scheduler delivers what music code depends
+// on: CIA 1 and 2 timer underflows, the raster counter with its compare
+// interrupt, and IRQ/NMI. Events are kept as the frame cycle they fall on,
+// like the CIA 1 timers, and looked at only when the earliest comes due
+// (nextEvent). Bad lines, sprite DMA and everything else the VIC does
+// aren't modelled; its other registers are plain RAM.
+
+static inline int c64_line_cycles() {
+    return S.isNTSC ? NTSC_CYCLES_PER_LINE : PAL_CYCLES_PER_LINE;
+}
+
+static inline int c64_raster_line() {
+    return (S.cpuCycle % S.cyclesPerFrame) / c64_line_cycles();
+}
+
+// Find the next raster compare match after the current cycle.
+static void c64_schedule_raster() {
+    MiniC64& m = S.c64;
+    int at = m.rasterCompare * c64_line_cycles();
+    if (at >= S.cyclesPerFrame) {
+        m.rasterEvent = INT_MAX;  // a line the frame doesn't have
+    } else {
+        m.rasterEvent = at > S.cpuCycle ? at : at + S.cyclesPerFrame;
+    }
+    m.nextEvent = 0;
+}
+
+static inline bool c64_irq() {
+    return (S.cia.flags & S.cia.irqMask & 0x1F) || (S.c64.vicIrqFlags & S.c64.vicIrqMask & 0x0F);
+}
+
+// CIA 2's interrupt output drives NMI, which is taken on its rising edge.
+static void c64_update_nmi() {
+    MiniC64& m = S.c64;
+    bool line = (m.cia2.flags & m.cia2.irqMask & 0x1F) != 0;
+    if (line && !m.nmiLine) m.nmiPending = true;
+    m.nmiLine = line;
+}
+
+// Latch the underflows of cia's timers due by `cycle`, reloading them.
+static void c64_timers_due(CIAState& cia, int cycle) {
+    for (int i = 0; i < 2; i++) {
+        CIATimer& t = cia.timer[i];
+        if (!cia_running(t) || t.underflow > cycle) continue;
+        cia.flags |= 1 << i;
+        if (t.control & 0x08) {
+            t.control &= ~0x01;
+            t.counter = t.latch;
+        } else {
+            int period = t.latch + 1;
+            t.underflow += ((cycle - t.underflow) / period + 1) * period;
+        }
+    }
+}
+
+// Deliver the events due by now and find the next.
+static void c64_events() {
+    MiniC64& m = S.c64;
+    int now = S.cpuCycle;
+    c64_timers_due(S.cia, now);
+    c64_timers_due(m.cia2, now);
+    c64_update_nmi();
+    if (m.rasterEvent <= now) {
+        m.vicIrqFlags |= 0x01;
+        m.rasterEvent += S.cyclesPerFrame;
+    }
+
+    int next = m.rasterEvent;
+    for (const CIAState* cia : { &S.cia, &m.cia2 }) {
+        for (const CIATimer& t : cia->timer) {
+            if (cia_running(t)) next = std::min(next, t.underflow);
+        }
+    }
+    m.nextEvent = next;
+}
+
+// Reading a CIA's ICR returns and clears its interrupt data.
+static uint8_t c64_read_icr(CIAState& cia) {
+    uint8_t value = cia.flags | ((cia.flags & cia.irqMask & 0x1F) ? 0x80 : 0);
+    cia.flags = 0;
+    return value;
+}
+
+// I/O reads the mini-C64 answers; -1 for plain RAM (and the SIDs).
+static int c64_io_read(uint16_t addr) {
+    MiniC64& m = S.c64;
+    if (addr < 0xD400) {
+        switch (addr & 0x3F) {  // VIC registers repeat every 64 bytes
+        case 0x11: return (S.memory[0xD011] & 0x7F) | ((c64_raster_line() >> 1) & 0x80);
+        case 0x12: return c64_raster_line() & 0xFF;
+        case 0x19: return m.vicIrqFlags | 0x70 | ((m.vicIrqFlags & m.vicIrqMask & 0x0F) ? 0x80 : 0);
+        case 0x1A: return m.vicIrqMask | 0xF0;
+        }
+        return -1;
+    }
+    if ((addr & 0xFF0F) == 0xDC0D) return c64_read_icr(S.cia);
+    if ((addr & 0xFF00) == 0xDD00) {
+        uint8_t reg = addr & 0x0F;
+        if (reg >= 0x04 && reg <= 0x07) {
+            uint16_t count = cia_count(m.cia2.timer[(reg >> 1) & 1], S.cpuCycle);
+            return (reg & 1) ? (count >> 8) : (count & 0xFF);
+        }
+        if (reg == 0x0D) {
+            uint8_t value = c64_read_icr(m.cia2);
+            c64_update_nmi();
+            return value;
+        }
+    }
+    return -1;
+}
+
+// I/O writes the mini-C64 takes (S.memory has the value already); false
+// for the SIDs.
+static bool c64_io_write(uint16_t addr, uint8_t val) {
+    MiniC64& m = S.c64;
+    if (addr < 0xD400) {
+        uint8_t reg = addr & 0x3F;
+        S.memory[0xD000 | reg] = val;
+        if (reg == 0x11 || reg == 0x12) {
+            m.rasterCompare = ((S.memory[0xD011] & 0x80) << 1) | S.memory[0xD012];
+            c64_schedule_raster();
+        }
+        else if (reg == 0x19) m.vicIrqFlags &= ~val;
+        else if (reg == 0x1A) m.vicIrqMask = val & 0x0F;
+        return true;
+    }
+    if ((addr & 0xFF00) == 0xDD00) {
+        cia_write(m.cia2, addr & 0x0F, val, S.cpuCycle);
+        c64_update_nmi();
+        m.nextEvent = 0;
+        return true;
+    }
+    return false;
+}
 
 // ---- Memory access with SID register interception ----
 
+static void init_log(int chip, uint8_t reg, uint8_t value, bool write) {
+    if ((int)S.initLog.size() <= INIT_LOG_MAX) {
+        S.initLog.push_back({ (uint8_t)chip, reg, value, write });
+    }
+}
+
+// While fast-forwarding without the SIDs (S.cpuOnly), SID reads come from
+// the register values in S.memory instead.
+static inline uint8_t sid_read(int chip, uint16_t addr) {
+    if (S.cpuOnly) return S.memory[addr];
+    if (S.initLogging) init_log(chip, addr & 0x1F, 0, false);
+    return S.sid[chip].read(addr & 0x1F);
+}
+
 static inline uint8_t mem_read(uint16_t addr) {
     // Primary SID reads
     if (addr >= 0xD400 && addr <= 0xD41F) {
-        return S.sid[0].read(addr & 0x1F);
+        return sid_read(0, addr);
+    }
+    // CIA 1 timer counts
+    if ((addr & 0xFFFC) == 0xDC04) {
+        uint16_t count = cia_count(S.cia.timer[(addr >> 1) & 1], S.cpuCycle);
+        return (addr & 1) ? (uint8_t)(count >> 8) : (uint8_t)count;
+    }
+    // Mini-C64: VIC raster and interrupt registers, CIA interrupts, CIA 2
+    if (S.machine && addr >= 0xD000 && addr < 0xDE00) {
+        int value = c64_io_read(addr);
+        if (value >= 0) return (uint8_t)value;
     }
     // Multi-SID reads
     for (int i = 1; i < S.sidCount; i++) {
         if (addr >= S.sidAddress[i] && addr < S.sidAddress[i] + 0x20) {
-            return S.sid[i].read(addr & 0x1F);
+            return sid_read(i, addr);
         }
     }
     return S.memory[addr];
 }
 
+// Play-routine writes are queued (their cycle is stamped by cpu_jsr once
+// the instruction's length is known); init-time writes apply immediately.
+static inline void sid_write(int chip, uint8_t reg, uint8_t val) {
+    if (S.cpuOnly) return;  // S.memory keeps the register values
+    if (S.deferWrites && S.writeCount < MAX_QUEUED_WRITES) {
+        S.writeQueue[S.writeCount++] = { 0, (uint8_t)chip, reg, val };
+        return;
+    }
+    if (S.initLogging) init_log(chip, reg, val, true);
+    S.sid[chip].write(reg, val);
+    // Flush MOS8580 write pipeline: with SAMPLE_FAST + MOS8580, reSID
+    // defers writes to a single-slot pipeline (only the LAST write is
+    // stored). Clock 1 cycle to apply each write immediately.
+    S.sid[chip].clock();
+}
+
 static inline void mem_write(uint16_t addr, uint8_t val) {
     S.memory[addr] = val;
 
     // Primary SID at $D400
     if (addr >= 0xD400 && addr <= 0xD41F) {
-        S.sid[0].write(addr & 0x1F, val);
-        // Flush MOS8580 write pipeline: with SAMPLE_FAST + MOS8580, reSID
-        // defers writes to a single-slot pipeline (only the LAST write is
-        // stored). Clock 1 cycle to apply each write immediately.
-        S.sid[0].clock();
+        sid_write(0, addr & 0x1F, val);
+        return;
+    }
+    // CIA 1 ($DC00-$DCFF, registers mirrored every 16 bytes)
+    if ((addr & 0xFF00) == 0xDC00) {
+        cia_write(S.cia, addr & 0x0F, val, S.cpuCycle);
+        if (S.machine) S.c64.nextEvent = 0;
+        return;
+    }
+    if (S.machine && addr >= 0xD000 && addr < 0xDE00 && c64_io_write(addr, val)) {
         return;
     }
     // Multi-SID chips
     for (int i = 1; i < S.sidCount; i++) {
         if (addr >= S.sidAddress[i] && addr < S.sidAddress[i] + 0x20) {
-            S.sid[i].write(addr & 0x1F, val);
-            S.sid[i].clock();
+            sid_write(i, addr & 0x1F, val);
             return;
         }
     }
     // SID mirror range ($D420-$D7FF) - mirror to chip 0 if no multi-SID mapped
     if (addr >= 0xD420 && addr < 0xD800) {
         S.memory[0xD400 | (addr & 0x1F)] = val;
-        S.sid[0].write(addr & 0x1F, val);
+        sid_write(0, addr & 0x1F, val);
     }
 }
 
@@ -622,23 +1166,135 @@ static void cpu_init(uint16_t pc) {
     S.st = FLAG_U | FLAG_I;
 }
 
-// Run a subroutine to completion or until maxCycles is exceeded.
+// Stamp the writes queued from index `first` on (by one instruction) with
+// the frame cycle its last cycle falls on, when a store's write happens.
+// Stamps stay strictly increasing so no two writes share a cycle.
+static inline void stamp_queued_writes(int first, int cycle) {
+    for (int i = first; i < S.writeCount; i++) {
+        int stamp = cycle;
+        if (i > 0 && stamp <= S.writeQueue[i - 1].cycle) {
+            stamp = S.writeQueue[i - 1].cycle + 1;
+        }
+        S.writeQueue[i].cycle = stamp;
+    }
+}
+
+// Run a subroutine to completion or until maxCycles is exceeded; returns the
+// cycles it ran.
 // A sentinel return address is pushed so the matching RTS lands on a known PC
 // and an SP-comparison can detect it without scanning the call graph.
-static void cpu_jsr(uint16_t addr, uint32_t maxCycles) {
+static uint32_t cpu_jsr(uint16_t addr, uint32_t maxCycles) {
     push16(0xFFFF);
     S.pc = addr;
     uint32_t cyclesRun = 0;
     uint8_t initialSP = S.sp + 2;  // SP before the sentinel push
 
     while (cyclesRun < maxCycles) {
+        int queued = S.writeCount;
+        S.cpuCycle = (int)cyclesRun;
         int cyc = cpu_step();
+        stamp_queued_writes(queued, (int)cyclesRun + cyc - 1);
         cyclesRun += cyc;
-        S.totalCycles += cyc;
 
-        if (S.sp >= initialSP) break;  // matching RTS executed
-        if (S.pc == 0 || S.pc == 0xFFFF) break;  // BRK or sentinel landing
+        if (S.sp >= initialSP) return cyclesRun;  // matching RTS executed
+        if (S.pc == 0 || S.pc == 0xFFFF) return cyclesRun;  // BRK or sentinel landing
+    }
+
+    S.stats.guardTrips++;
+    S.stats.guardCycles += cyclesRun;
+    return cyclesRun;
+}
+
+// ---- Mini-C64 run loop ----
+
+// Take an IRQ or NMI: 7 cycles. With the Kernal banked in its vectors are
+// the ones that count (they lead to the entry code audio_load_sid puts at
+// $FF48 and $FE43); otherwise the tune's own at $FFFE/$FFFA.
+static int c64_interrupt(bool nmi) {
+    push16(S.pc);
+    push8((S.st & ~FLAG_B) | FLAG_U);
+    S.st |= FLAG_I;
+    if (S.memory[0x01] & 0x02) {
+        S.pc = nmi ? 0xFE43 : 0xFF48;
+    } else {
+        uint16_t vector = nmi ? 0xFFFA : 0xFFFE;
+        S.pc = S.memory[vector] | (S.memory[vector + 1] << 8);
+    }
+    return 7;
+}
+
+// Run the machine up to frame cycle `end` (the last instruction may run
+// past it), queueing SID writes as a play call does. PC $0000 is where
+// init's RTS lands (see c64_start): the CPU idles there until an interrupt.
+// Returns the cycles the CPU was busy.
+static uint32_t c64_run(int end) {
+    MiniC64& m = S.c64;
+    uint32_t busy = 0;
+    while (S.cpuCycle < end) {
+        if (S.cpuCycle >= m.nextEvent) c64_events();
+
+        int cyc;
+        if (m.nmiPending) {
+            m.nmiPending = false;
+            cyc = c64_interrupt(true);
+        } else if (!(S.st & FLAG_I) && c64_irq()) {
+            cyc = c64_interrupt(false);
+        } else if (S.pc == 0) {
+            S.cpuCycle = std::min(end, m.nextEvent);
+            continue;
+        } else {
+            int queued = S.writeCount;
+            cyc = cpu_step();
+            stamp_queued_writes(queued, S.cpuCycle + cyc - 1);
+        }
+        S.cpuCycle += cyc;
+        busy += cyc;
+    }
+    return busy;
+}
+
+// Start a subtune as the C64 would run SYS <init>: interrupts enabled, the
+// subtune in A (and X and Y, as for PSIDs). Init runs as part of the first
+// frames; if it returns, the interrupts it set up do the playing.
+static void c64_start(int subtune) {
+    cpu_init(S.initAddress);
+    S.a = S.x = S.y = subtune;
+    S.st = FLAG_U;
+    push16(0xFFFF);  // init's RTS lands on $0000: idle
+    S.totalCycles = 0;
+    S.initLog.clear();
+
+    MiniC64& m = S.c64;
+    m = MiniC64{};
+    for (CIATimer& t : m.cia2.timer) {
+        t.latch = t.counter = 0xFFFF;
     }
+    S.cpuCycle = 0;
+    c64_schedule_raster();
+}
+
+// One video frame of the mini-C64. Every cycle of it is emulated, so its
+// SID writes are queued with the cycle they happen on, as a play call's.
+static void c64_frame() {
+    MiniC64& m = S.c64;
+    int frame = S.cyclesPerFrame;
+    S.cpuCycle = m.carry;
+    S.deferWrites = true;
+    uint32_t cycles = c64_run(frame);
+    S.deferWrites = false;
+    S.stats.playCalls++;
+    S.stats.playCycles += cycles;
+    S.stats.playCyclesMax = std::max(S.stats.playCyclesMax, cycles);
+
+    // Events the last instruction ran past, then renumber from the next frame
+    if (S.cpuCycle >= m.nextEvent) c64_events();
+    m.carry = S.cpuCycle - frame;
+    cia_advance(S.cia, frame);
+    cia_advance(m.cia2, frame);
+    if (m.rasterEvent != INT_MAX) m.rasterEvent -= frame;
+    m.nextEvent = 0;
+    S.remainingCycles += frame;
+    S.frameCycles = S.remainingCycles;
 }
 
 // ---- SID file header (PSID/RSID v1-v4) ----
@@ -662,12 +1318,450 @@ struct SIDFileHeader {
 
 static uint16_t be16(uint8_t hi, uint8_t lo) { return (hi << 8) | lo; }
 
+// reSID's reset() models the real chip, which keeps oscillator phases,
+// envelope and waveform pipelines and filter history, so a reused engine
+// would sound slightly different depending on what played before.
+// Rebuilding the chip gives every loaded tune the same starting point.
+static void rebuild_chip(int chip) {
+    S.sid[chip].~SID();
+    new (&S.sid[chip]) reSID::SID();
+}
+
+// Fresh chips of S.chipModel for S.sidCount SIDs, at the default sampling
+// method, stereo spread (2SID left/right, 3SID left/centre/right) and gain.
+static void build_chips() {
+    reSID::chip_model model = (S.chipModel == 8580) ? reSID::MOS8580 : reSID::MOS6581;
+    for (int i = 0; i < S.sidCount; i++) {
+        rebuild_chip(i);
+        S.sid[i].reset();
+        S.sid[i].set_chip_model(model);
+        S.sid[i].set_sampling_parameters(S.clockFreq, reSID::SAMPLE_INTERPOLATE, S.sampleRate);
+    }
+
+    S.samplingMethod = S.methodCeiling = 1;
+    S.renderLoad = 0.0;
+    S.governorHold = S.governorCalm = 0.0;
+
+    static const float defaultPan[MAX_SID_CHIPS][MAX_SID_CHIPS] = {
+        { 0.0f,  0.0f, 0.0f },
+        { -0.6f, 0.6f, 0.0f },
+        { -0.6f, 0.0f, 0.6f }
+    };
+    for (int i = 0; i < MAX_SID_CHIPS; i++) {
+        S.chipPan[i] = defaultPan[S.sidCount - 1][i];
+        S.chipGain[i] = 1.0f;
+    }
+}
+
+// ---- Seek snapshots ----
+// Taken at frame boundaries (queue empty, before the play call). RAM is
+// stored as the pages that differ from the image right after init, which
+// for most tunes is a few KB.
+
+static void seek_clear_index() {
+    S.seekSlots.clear();
+    S.seekBytes = 0;
+    S.seekBase.clear();
+}
+
+static void seek_reset_index() {
+    seek_clear_index();
+    S.seekBase.assign(S.memory, S.memory + sizeof(S.memory));
+    S.seekOrigin = S.totalCycles;
+}
+
+// Snapshot RAM held by every instance. They share one budget because they
+// share one heap: the WASM module is capped at 64 MB (0-build.bat), and
+// reSID's filter tables take up to about 21 MB of it.
+static size_t seek_bytes_in_use() {
+    size_t total = 0;
+    for (const auto& engine : g_engines) {
+        if (engine) total += engine->seekBytes;
+    }
+    return total;
+}
+
+// Record the current state in its interval's slot, unless the slot already
+// holds a snapshot at least as good.
+static void seek_record(bool exact) {
+    if (S.seekBase.empty() || S.totalCycles < S.seekOrigin) return;
+    size_t slot = (size_t)((S.totalCycles - S.seekOrigin) / S.seekInterval);
+    if (slot >= S.seekSlots.size()) {
+        if (seek_bytes_in_use() >= SEEK_MAX_BYTES) return;
+        S.seekSlots.resize(slot + 1);
+    }
+
+    auto& snap = S.seekSlots[slot];
+    if (snap.valid && (snap.exact || !exact)) return;
+
+    S.seekBytes -= snap.pages.size();
+    snap.pages.clear();
+    for (int page = 0; page < 256; page++) {
+        const uint8_t* mem = S.memory + page * 256;
+        if (memcmp(mem, S.seekBase.data() + page * 256, 256) != 0) {
+            snap.pages.push_back((uint8_t)page);
+            snap.pages.insert(snap.pages.end(), mem, mem + 256);
+        }
+    }
+    S.seekBytes += snap.pages.size();
+
+    snap.valid = true;
+    snap.exact = exact;
+    snap.totalCycles = S.totalCycles;
+    snap.remainingCycles = S.remainingCycles;
+    snap.pc = S.pc; snap.sp = S.sp;
+    snap.a = S.a; snap.x = S.x; snap.y = S.y; snap.st = S.st;
+    snap.cia = S.cia;
+    snap.c64 = S.c64;
+    snap.dumpCursor = S.dumpCursor;
+    if (exact) {
+        for (int i = 0; i < S.sidCount; i++) {
+            snap.sidState[i] = S.sid[i].read_state();
+        }
+    }
+}
+
+// Restore RAM, CPU and frame position; the SIDs too if the snapshot has them
+// and restoreSID is set.
+static void seek_restore(const SeekSnapshot& snap, bool restoreSID) {
+    memcpy(S.memory, S.seekBase.data(), sizeof(S.memory));
+    for (size_t i = 0; i < snap.pages.size(); i += 257) {
+        memcpy(S.memory + snap.pages[i] * 256, &snap.pages[i + 1], 256);
+    }
+    S.pc = snap.pc; S.sp = snap.sp;
+    S.a = snap.a; S.x = snap.x; S.y = snap.y; S.st = snap.st;
+    S.cia = snap.cia;
+    S.c64 = snap.c64;
+    S.dumpCursor = snap.dumpCursor;
+    S.totalCycles = snap.totalCycles;
+    S.remainingCycles = snap.remainingCycles;
+    S.writeCount = 0;
+    S.writeNext = 0;
+    if (restoreSID && snap.exact) {
+        for (int i = 0; i < S.sidCount; i++) {
+            S.sid[i].write_state(snap.sidState[i]);
+        }
+    }
+}
+
+// ---- Init snapshots ----
+// Flicking between subtunes or back to a recent tune would otherwise re-run
+// the init routine every time. Each subtune starts from the loaded image,
+// so the state init leaves behind depends only on the tune, the subtune and
+// the chip model; it is cached per combination, least recently used first
+// out. The chips aren't snapshotted: their init-time accesses are replayed.
+
+static uint64_t fnv1a64(const uint8_t* data, size_t length, uint64_t h = 0xCBF29CE484222325ull) {
+    for (size_t i = 0; i < length; i++) {
+        h = (h ^ data[i]) * 0x100000001B3ull;
+    }
+    return h;
+}
+
+static uint64_t init_cache_key(int subtune) {
+    int params[2] = { subtune, S.chipModel };
+    return fnv1a64((const uint8_t*)params, sizeof(params), S.tuneHash);
+}
+
+static InitSnapshot* init_cache_find(uint64_t key) {
+    for (auto& snap : S.initCache) {
+        if (snap.key == key) return &snap;
+    }
+    return nullptr;
+}
+
+// Store the state init just left, replacing the least recently used entry
+// once the cache is full.
+static void init_cache_store(uint64_t key) {
+    if ((int)S.initLog.size() > INIT_LOG_MAX) return;
+
+    InitSnapshot* snap = nullptr;
+    if ((int)S.initCache.size() < INIT_CACHE_ENTRIES) {
+        S.initCache.emplace_back();
+        snap = &S.initCache.back();
+    } else {
+        snap = &*std::min_element(S.initCache.begin(), S.initCache.end(),
+            [](const InitSnapshot& a, const InitSnapshot& b) { return a.lastUse < b.lastUse; });
+    }
+
+    snap->key = key;
+    snap->lastUse = ++S.initCacheClock;
+    snap->pc = S.pc; snap->sp = S.sp;
+    snap->a = S.a; snap->x = S.x; snap->y = S.y; snap->st = S.st;
+    snap->cyclesPerFrame = S.cyclesPerFrame;
+    snap->playAddress = S.playAddress;
+    snap->cia = S.cia;
+    snap->pages.clear();
+    for (int page = 0; page < 256; page++) {
+        const uint8_t* mem = S.memory + page * 256;
+        if (memcmp(mem, S.loadImage.data() + page * 256, 256) != 0) {
+            snap->pages.push_back((uint8_t)page);
+            snap->pages.insert(snap->pages.end(), mem, mem + 256);
+        }
+    }
+    snap->sidLog = S.initLog;
+}
+
+// Put RAM, CPU and chips where init left them. Expects the loaded image in
+// S.memory and freshly reset chips.
+static void init_cache_restore(InitSnapshot& snap) {
+    snap.lastUse = ++S.initCacheClock;
+    for (size_t i = 0; i < snap.pages.size(); i += 257) {
+        memcpy(S.memory + snap.pages[i] * 256, &snap.pages[i + 1], 256);
+    }
+    S.pc = snap.pc; S.sp = snap.sp;
+    S.a = snap.a; S.x = snap.x; S.y = snap.y; S.st = snap.st;
+    S.totalCycles = 0;  // play time starts after init, as when init runs
+    S.cyclesPerFrame = snap.cyclesPerFrame;
+    S.playAddress = snap.playAddress;
+    S.cia = snap.cia;
+    for (const auto& access : snap.sidLog) {
+        reSID::SID& sid = S.sid[access.chip];
+        if (access.write) {
+            sid.write(access.reg, access.value);
+            sid.clock();  // as sid_write
+        } else {
+            sid.read(access.reg);
+        }
+    }
+}
+
+// Playback moved (load, subtune, seek): silence heard so far no longer
+// counts (see "End-of-tune detection")
+static void silence_reset() {
+    S.quietSamples = 0;
+    S.skipping = false;
+}
+
+// What every loader does last: nothing playing, no seek index yet, and the
+// image subtunes start from.
+static void finish_load(const uint8_t* data, int length) {
+    S.renderActive = false;
+    seek_clear_index();
+    S.seekInterval = (uint64_t)(SEEK_DEFAULT_INTERVAL * S.clockFreq);
+    S.tuneHash = fnv1a64(data, length);
+    S.loadImage.assign(S.memory, S.memory + sizeof(S.memory));
+    S.loaded = true;
+    S.totalCycles = 0;
+    silence_reset();
+}
+
+// ---- Register dumps ----
+// A register dump holds one subtune's SID writes, recorded by
+// audio_dump_capture, so it can be played without running the 6510:
+// audio_load_sid accepts one in place of a SID file. Writes that leave a
+// register unchanged are dropped, runs of frames without writes are
+// counted instead of stored, and when the machine comes back to the state
+// of an earlier frame the dump stops there with a loop marker.
+//
+// Layout (little-endian):
+//    0  "SIDD"
+//    4  version (DUMP_VERSION)
+//    5  chip count (1-3)
+//    6  flags: bit 0 NTSC clock
+//    8  model per chip, 3 bytes: 0 = 6581, 1 = 8580
+//   12  base address per chip, 3 x 16 bits
+//   20  frame count
+//   24  loop frame (DUMP_NO_LOOP: play stops writing after the last frame)
+//   28  offset of the loop frame's record
+//   32  init write count
+//   36  init writes, 2 bytes each: chip << 5 | register, value
+//       frame records
+//
+// A frame record starts with one byte:
+//   1nnnnnnn   n + 1 frames without writes, as long as the previous one
+//   0Lcccccc   c writes (63: 63 + a varint); L: a varint frame length
+//              in cycles follows (always set on the first and loop frames)
+// and then, per write: chip << 5 | register, a varint of cycles since the
+// previous write (or the frame start), the value. Varints are LEB128.
+
+static const uint8_t DUMP_VERSION = 1;
+static const int DUMP_HEADER_BYTES = 36;
+static const uint32_t DUMP_NO_LOOP = 0xFFFFFFFF;
+static const uint32_t DUMP_MAX_CYCLES = 0xFFFFFF;  // per frame, and write offsets within one
+
+static inline uint32_t get_le32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static bool get_varint(const uint8_t* data, uint32_t size, uint32_t& offset, uint32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 35 && offset < size; shift += 7) {
+        uint8_t b = data[offset++];
+        value |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+// Check a dump's header and records, so playback can trust them.
+static bool dump_validate(const uint8_t* data, uint32_t size) {
+    int chips = data[5];
+    uint32_t frames = get_le32(data + 20);
+    uint32_t loopFrame = get_le32(data + 24);
+    uint32_t loopOffset = get_le32(data + 28);
+    uint32_t initWrites = get_le32(data + 32);
+    if (chips < 1 || chips > MAX_SID_CHIPS) return false;
+    for (int i = 0; i < chips; i++) {
+        if ((data[12 + i * 2] | (data[13 + i * 2] << 8)) > 0xFFE0) return false;
+    }
+    if (loopFrame != DUMP_NO_LOOP && loopFrame >= frames) return false;
+    if (initWrites > (size - DUMP_HEADER_BYTES) / 2) return false;
+    for (uint32_t i = 0; i < initWrites; i++) {
+        if ((data[DUMP_HEADER_BYTES + i * 2] >> 5) >= chips) return false;
+    }
+
+    uint32_t offset = DUMP_HEADER_BYTES + initWrites * 2;
+    for (uint32_t frame = 0; frame < frames; ) {
+        if (offset >= size) return false;
+        uint8_t head = data[offset];
+        if ((frame == 0 || frame == loopFrame) && (head & 0xC0) != 0x40) return false;
+        if (frame == loopFrame && offset != loopOffset) return false;
+        offset++;
+
+        if (head & 0x80) {
+            uint32_t run = (head & 0x7F) + 1u;
+            if (run > frames - frame) return false;
+            if (loopFrame > frame && loopFrame < frame + run) return false;
+            frame += run;
+            continue;
+        }
+
+        uint32_t count = head & 0x3F, value = 0, cycle = 0;
+        if (count == 0x3F) {
+            if (!get_varint(data, size, offset, value)) return false;
+            count += value;
+        }
+        if (head & 0x40) {
+            if (!get_varint(data, size, offset, value) || value == 0 || value > DUMP_MAX_CYCLES) return false;
+        }
+        for (uint32_t i = 0; i < count; i++) {
+            if (offset >= size || (data[offset++] >> 5) >= chips) return false;
+            if (!get_varint(data, size, offset, value) || offset >= size) return false;
+            cycle += value;
+            if (cycle > DUMP_MAX_CYCLES) return false;
+            offset++;
+        }
+        frame++;
+    }
+    return true;
+}
+
+// audio_load_sid for a register dump.
+static int load_dump(const uint8_t* data, int length) {
+    if (length < DUMP_HEADER_BYTES) return -1;
+    if (data[4] != DUMP_VERSION) return -3;
+    if (!dump_validate(data, (uint32_t)length)) return -4;
+
+    S.loadAddress = S.initAddress = S.playAddress = S.headerPlayAddress = 0;
+    S.songs = S.startSong = 1;
+    S.speed = 0;
+    S.name[0] = S.author[0] = S.copyright[0] = 0;
+    S.flags = 0;
+    S.secondSIDAddr = S.thirdSIDAddr = 0;
+    S.isNTSC = (data[6] & 1) != 0;
+    S.clockFreq = S.isNTSC ? NTSC_CLOCK : PAL_CLOCK;
+    S.cyclesPerFrame = S.isNTSC ? NTSC_CYCLES_PER_FRAME : PAL_CYCLES_PER_FRAME;
+    S.chipModel = data[8] ? 8580 : 6581;
+    S.sidCount = data[5];
+    for (int i = 0; i < S.sidCount; i++) {
+        S.sidAddress[i] = data[12 + i * 2] | (data[13 + i * 2] << 8);
+    }
+
+    memset(S.memory, 0, sizeof(S.memory));
+    S.memory[0x01] = 0x37;
+    build_chips();
+    for (int i = 1; i < S.sidCount; i++) {
+        if (data[8 + i] != data[8]) {
+            S.sid[i].set_chip_model(data[8 + i] ? reSID::MOS8580 : reSID::MOS6581);
+        }
+    }
+
+    S.machine = false;
+    S.dump.assign(data, data + length);
+    S.dumpFrames = get_le32(data + 20);
+    S.dumpLoopFrame = get_le32(data + 24);
+    S.dumpLoopOffset = get_le32(data + 28);
+    S.dumpInitWrites = get_le32(data + 32);
+    finish_load(data, length);
+    return 0;
+}
+
+// Back to the start of the dump: the init routine's writes, applied as
+// init made them, then frame 0.
+static void dump_restart() {
+    const uint8_t* writes = S.dump.data() + DUMP_HEADER_BYTES;
+    for (uint32_t i = 0; i < S.dumpInitWrites; i++) {
+        int chip = writes[i * 2] >> 5, reg = writes[i * 2] & 0x1F;
+        S.memory[S.sidAddress[chip] + reg] = writes[i * 2 + 1];
+        S.sid[chip].write(reg, writes[i * 2 + 1]);
+        S.sid[chip].clock();  // as sid_write
+    }
+    S.dumpCursor = { DUMP_HEADER_BYTES + S.dumpInitWrites * 2, 0, 0, S.cyclesPerFrame };
+}
+
+static inline uint32_t dump_varint(uint32_t& offset) {
+    uint32_t value = 0;
+    get_varint(S.dump.data(), (uint32_t)S.dump.size(), offset, value);
+    return value;
+}
+
+// Queue the next frame's writes, as a play call would (S.memory gets the
+// register values too, for the register stream and seeks), and return the
+// frame's length in cycles. A dump without a loop goes quiet at its end.
+static int dump_next_frame() {
+    DumpCursor& c = S.dumpCursor;
+    if (c.frame >= S.dumpFrames) {
+        if (S.dumpLoopFrame == DUMP_NO_LOOP) return c.length;
+        c.offset = S.dumpLoopOffset;
+        c.frame = S.dumpLoopFrame;
+        c.run = 0;
+    }
+    c.frame++;
+    if (c.run > 0) {
+        c.run--;
+        return c.length;
+    }
+
+    const uint8_t* data = S.dump.data();
+    uint8_t head = data[c.offset++];
+    if (head & 0x80) {
+        c.run = head & 0x7F;
+        return c.length;
+    }
+    uint32_t count = head & 0x3F;
+    if (count == 0x3F) count += dump_varint(c.offset);
+    if (head & 0x40) c.length = (int)dump_varint(c.offset);
+
+    int cycle = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        uint8_t target = data[c.offset++];
+        cycle += (int)dump_varint(c.offset);
+        uint8_t value = data[c.offset++];
+        int chip = target >> 5, reg = target & 0x1F;
+        S.memory[S.sidAddress[chip] + reg] = value;
+        if (S.cpuOnly) continue;
+        if (S.writeCount < MAX_QUEUED_WRITES) {
+            S.writeQueue[S.writeCount++] = { cycle, (uint8_t)chip, (uint8_t)reg, value };
+        } else {
+            S.sid[chip].write(reg, value);
+        }
+    }
+    return c.length;
+}
+
 // ====================================================================
 // WASM-exported functions
 // ====================================================================
 
 EMSCRIPTEN_KEEPALIVE
 void audio_init(double sampleRate) {
+    // The first call makes the default instance
+    if (!g_engine) {
+        if (g_engines.empty()) g_engines.emplace_back(new EngineState());
+        g_engine = g_engines[0].get();
+    }
+
     // Field-by-field reset: must NOT memset over the reSID::SID instances,
     // which are non-POD and own constructed state.
     S.pc = 0; S.sp = 0; S.a = 0; S.x = 0; S.y = 0; S.st = 0;
@@ -689,27 +1783,123 @@ void audio_init(double sampleRate) {
     S.isNTSC = false;
     S.loaded = false;
     S.remainingCycles = 0;
+    S.ciaSpeed = false;
+    cia_reset();
+    S.machine = false;
+    S.c64 = {};
+    S.dump.clear();
+    S.cpuCycle = 0;
     S.playRoutineActive = false;
     S.totalCycles = 0;
     S.chipModel = 6581;
+    S.writeCount = 0;
+    S.writeNext = 0;
+    S.deferWrites = false;
+    S.frameCycles = 0;
+    for (int i = 0; i < MAX_SID_CHIPS; i++) {
+        S.chipPan[i] = 0.0f;
+        S.chipGain[i] = 1.0f;
+    }
+    S.renderActive = false;
+    seek_clear_index();
+    S.seekInterval = (uint64_t)(SEEK_DEFAULT_INTERVAL * S.clockFreq);
+    S.cpuOnly = false;
+    S.tapBuffer = nullptr;
+    S.tapCapacity = 0;
+    S.tapDecimation = 1;
+    S.tapPhase = 0;
+    S.tapCount = 0;
+    S.regFrames = nullptr;
+    S.regFrameSamples = nullptr;
+    S.regCapacity = 0;
+    S.regCount = 0;
+    S.outputSamples = 0;
+    S.headerPlayAddress = 0;
+    S.tuneHash = 0;
+    S.loadImage.clear();
+    S.initCache.clear();
+    S.initLog.clear();
+    S.initLogging = false;
+    S.initCacheClock = 0;
+    S.samplingMethod = 1;
+    S.methodCeiling = 1;
+    S.governorOn = false;
+    S.renderLoad = 0.0;
+    S.governorHold = 0.0;
+    S.governorCalm = 0.0;
+    S.stats = {};
+    S.silenceSeconds = SILENCE_DEFAULT_SECONDS;
+    S.silenceSkip = false;
+    S.quietSamples = 0;
+    S.skipping = false;
+    S.skipPhase = 0.0;
+    for (int i = 0; i < MAX_SID_CHIPS; i++) {
+        S.lastSample[i] = 0;
+    }
 }
 
-EMSCRIPTEN_KEEPALIVE
-int audio_load_sid(const uint8_t* data, int length) {
-    if (length < 0x7C) return -1;
+// ---- Instances ----
+// Further engines, e.g. to preview a tune while another plays or to
+// crossfade between two. Every other call acts on the selected instance.
 
-    const SIDFileHeader* hdr = (const SIDFileHeader*)data;
+// Make and initialize a new instance (as audio_init); returns its handle.
+// The selection is unchanged, except that the default instance is made and
+// selected if there was none.
+EMSCRIPTEN_KEEPALIVE
+int audio_create(double sampleRate) {
+    if (!g_engine) audio_init(sampleRate);
+    EngineState* selected = g_engine;
+
+    size_t handle = 1;
+    while (handle < g_engines.size() && g_engines[handle]) handle++;
+    if (handle == g_engines.size()) g_engines.emplace_back();
+    g_engines[handle].reset(new EngineState());
+
+    g_engine = g_engines[handle].get();
+    audio_init(sampleRate);
+    g_engine = selected;
+    return (int)handle;
+}
 
-    if (memcmp(hdr->magicID, "PSID", 4) != 0 &&
+// Free an instance made by audio_create; selecting it afterwards fails. If
+// it was selected, the default instance is selected instead.
+EMSCRIPTEN_KEEPALIVE
+int audio_destroy(int handle) {
+    if (handle <= 0 || handle >= (int)g_engines.size() || !g_engines[handle]) return -1;
+    if (g_engine == g_engines[handle].get()) g_engine = g_engines[0].get();
+    g_engines[handle].reset();
+    return 0;
+}
+
+// Returns 0, or -1 (selection unchanged) for an unknown handle.
+EMSCRIPTEN_KEEPALIVE
+int audio_select(int handle) {
+    if (handle < 0 || handle >= (int)g_engines.size() || !g_engines[handle]) return -1;
+    g_engine = g_engines[handle].get();
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int audio_load_sid(const uint8_t* data, int length) {
+    if (length >= 4 && memcmp(data, "SIDD", 4) == 0) return load_dump(data, length);
+    if (length < 0x7C) return -1;
+
+    const SIDFileHeader* hdr = (const SIDFileHeader*)data;
+
+    if (memcmp(hdr->magicID, "PSID", 4) != 0 &&
         memcmp(hdr->magicID, "RSID", 4) != 0) {
         return -2;
     }
 
     uint16_t version    = be16(hdr->versionHi, hdr->versionLo);
     uint16_t dataOffset = be16(hdr->dataOffsetHi, hdr->dataOffsetLo);
+    bool rsid = memcmp(hdr->magicID, "RSID", 4) == 0;
+    // RSID flag bit 1: a BASIC program, which needs the BASIC ROM to RUN
+    if (rsid && version >= 2 && (data[0x77] & 0x02)) return -5;
     S.loadAddress  = be16(hdr->loadAddrHi, hdr->loadAddrLo);
     S.initAddress  = be16(hdr->initAddrHi, hdr->initAddrLo);
     S.playAddress  = be16(hdr->playAddrHi, hdr->playAddrLo);
+    S.headerPlayAddress = S.playAddress;
     S.songs        = be16(hdr->songsHi, hdr->songsLo);
     S.startSong    = be16(hdr->startSongHi, hdr->startSongLo);
     S.speed        = ((uint32_t)hdr->speedB3 << 24) | ((uint32_t)hdr->speedB2 << 16) |
@@ -824,18 +2014,43 @@ int audio_load_sid(const uint8_t* data, int length) {
         S.memory[0x0319] = 0xEA;
     }
 
+    // RSID tunes run on the mini-C64, which takes real interrupts, so they
+    // get the Kernal's own entry and exit code (at its real addresses) in
+    // place of the bare RTIs: the IRQ entry saves A/X/Y and jumps through
+    // $0314 (or $0316 after a BRK), $EA31 acknowledges CIA 1 and restores
+    // them, and the NMI entry jumps through $0318 to a default handler
+    // that acknowledges CIA 2.
+    S.machine = rsid;
+    if (S.machine) {
+        static const uint8_t ea31[] = {0x4C,0x7E,0xEA};                    // JMP $EA7E
+        static const uint8_t ea7e[] = {0xAD,0x0D,0xDC,                     // LDA $DC0D
+                                       0x68,0xA8,0x68,0xAA,0x68,0x40};     // $EA81: PLA/TAY/PLA/TAX/PLA/RTI
+        static const uint8_t fe43[] = {0x78,0x6C,0x18,0x03,                // SEI / JMP ($0318)
+                                       0x48,0x8A,0x48,0x98,0x48,           // $FE47: PHA/TXA/PHA/TYA/PHA
+                                       0xAD,0x0D,0xDD,0x4C,0xBC,0xFE};     // LDA $DD0D / JMP $FEBC
+        static const uint8_t febc[] = {0x68,0xA8,0x68,0xAA,0x68,0x40};     // PLA/TAY/PLA/TAX/PLA/RTI
+        static const uint8_t ff48[] = {0x48,0x8A,0x48,0x98,0x48,           // PHA/TXA/PHA/TYA/PHA
+                                       0xBA,0xBD,0x04,0x01,0x29,0x10,      // TSX / LDA $0104,X / AND #$10
+                                       0xF0,0x03,0x6C,0x16,0x03,           // BEQ +3 / JMP ($0316)
+                                       0x6C,0x14,0x03};                    // JMP ($0314)
+        memcpy(&S.memory[0xEA31], ea31, sizeof(ea31));
+        memcpy(&S.memory[0xEA7E], ea7e, sizeof(ea7e));
+        memcpy(&S.memory[0xFE43], fe43, sizeof(fe43));
+        memcpy(&S.memory[0xFEBC], febc, sizeof(febc));
+        memcpy(&S.memory[0xFF48], ff48, sizeof(ff48));
+        S.memory[0x0318] = 0x47;  // NMI vector -> $FE47
+        S.memory[0x0319] = 0xFE;
+        S.memory[0xFFFA] = 0x43;  // hardware NMI vector -> $FE43
+        S.memory[0xFFFB] = 0xFE;
+    }
+
     // Load the tune's data LAST, so it overrides any overlapping stub/vector
     // bytes above (a tune loaded over the Kernal region keeps its own data).
     if (musicLen > 0 && S.loadAddress + musicLen <= 65536) {
         memcpy(&S.memory[S.loadAddress], musicData, musicLen);
     }
 
-    reSID::chip_model model = (S.chipModel == 8580) ? reSID::MOS8580 : reSID::MOS6581;
-    for (int i = 0; i < S.sidCount; i++) {
-        S.sid[i].reset();
-        S.sid[i].set_chip_model(model);
-        S.sid[i].set_sampling_parameters(S.clockFreq, reSID::SAMPLE_INTERPOLATE, S.sampleRate);
-    }
+    build_chips();
 
     // PSID v2+ flag bits 6-7 select the second chip's model independently.
     if (version >= 2) {
@@ -846,8 +2061,8 @@ int audio_load_sid(const uint8_t* data, int length) {
         }
     }
 
-    S.loaded = true;
-    S.totalCycles = 0;
+    S.dump.clear();
+    finish_load(data, length);
     return 0;
 }
 
@@ -860,87 +2075,676 @@ void audio_set_subtune(int subtune) {
         S.sid[i].reset();
     }
 
+    // Every subtune starts from the loaded image, as a fresh load would, so
+    // what init leaves behind doesn't depend on what played before.
+    memcpy(S.memory, S.loadImage.data(), sizeof(S.memory));
     S.memory[0x01] = 0x37;
+    S.cyclesPerFrame = S.isNTSC ? NTSC_CYCLES_PER_FRAME : PAL_CYCLES_PER_FRAME;
+    S.playAddress = S.headerPlayAddress;
+    S.ciaSpeed = (S.speed & (1 << (subtune & 31))) != 0;
+    cia_reset();
+
+    uint64_t key = init_cache_key(subtune);
+    if (!S.dump.empty()) {
+        dump_restart();
+    } else if (S.machine) {
+        c64_start(subtune);
+    } else if (InitSnapshot* snap = init_cache_find(key)) {
+        init_cache_restore(*snap);
+    } else {
+        // PSID convention: the subtune index (0-based) is passed in A — and also in
+        // X and Y. Some tunes read the song number from X or Y (e.g. an init doing
+        // "LDA songtable,X") rather than A; passing all three matches how a real
+        // driver and SIDquake's own export engine call init, so playback and export
+        // stay consistent (fixes multi-song tunes that sounded corrupt on preview).
+        cpu_init(S.initAddress);
+        S.a = S.x = S.y = subtune;
+        S.totalCycles = 0;
+
+        S.initLog.clear();
+        S.initLogging = true;
+        cpu_jsr(S.initAddress, 1000000);
+        S.initLogging = false;
+
+        // CIA-driven tunes (speed bit set) start at the timer A period init
+        // left; start_frame follows the timers from there.
+        if (S.ciaSpeed && S.cia.timer[0].latch > 0) {
+            S.cyclesPerFrame = S.cia.timer[0].latch + 1;
+        }
 
-    // PSID convention: the subtune index (0-based) is passed in A — and also in
-    // X and Y. Some tunes read the song number from X or Y (e.g. an init doing
-    // "LDA songtable,X") rather than A; passing all three matches how a real
-    // driver and SIDquake's own export engine call init, so playback and export
-    // stay consistent (fixes multi-song tunes that sounded corrupt on preview).
-    cpu_init(S.initAddress);
-    S.a = S.x = S.y = subtune;
-    S.totalCycles = 0;
+        // Implicit play address: derive from the IRQ vectors the init routine set.
+        if (S.playAddress == 0) {
+            if ((S.memory[0x01] & 3) < 2) {
+                S.playAddress = S.memory[0xFFFE] | (S.memory[0xFFFF] << 8);
+            } else {
+                S.playAddress = S.memory[0x0314] | (S.memory[0x0315] << 8);
+            }
+        }
+
+        init_cache_store(key);
+    }
 
-    cpu_jsr(S.initAddress, 1000000);
+    S.remainingCycles = 0;
+    S.writeCount = 0;
+    S.writeNext = 0;
+    cia_start();
+
+    // The seek index starts here, with the state init left behind
+    seek_reset_index();
+    seek_record(true);
+    silence_reset();
+}
 
-    // CIA-driven tunes (speed bit set) latch the play period in $DC04/$DC05.
-    if (S.speed & (1 << (subtune & 31))) {
-        uint16_t timerVal = S.memory[0xDC04] | (S.memory[0xDC05] << 8);
-        if (timerVal > 0) {
-            S.cyclesPerFrame = timerVal;
+// Apply queued writes up to and including frame cycle `cycle`.
+static inline void apply_queued_writes(int cycle) {
+    while (S.writeNext < S.writeCount && S.writeQueue[S.writeNext].cycle <= cycle) {
+        const auto& w = S.writeQueue[S.writeNext++];
+        S.sid[w.chip].write(w.reg, w.value);
+    }
+}
+
+// Make sure every chip's render buffer can hold numSamples samples (plus
+// the spare slot render_chips lends chips after the first).
+static void reserve_chip_buffers(int numSamples) {
+    for (int chip = 0; chip < S.sidCount; chip++) {
+        if ((int)S.chipBuffer[chip].size() < numSamples + 1) {
+            S.chipBuffer[chip].resize(numSamples + 1);
         }
     }
+}
 
-    // Implicit play address: derive from the IRQ vectors the init routine set.
-    if (S.playAddress == 0) {
-        if ((S.memory[0x01] & 3) < 2) {
-            S.playAddress = S.memory[0xFFFE] | (S.memory[0xFFFF] << 8);
-        } else {
-            S.playAddress = S.memory[0x0314] | (S.memory[0x0315] << 8);
+// Whether frames have anything to run: a play routine, the mini-C64 or a
+// register dump.
+static inline bool has_play() {
+    return S.playAddress != 0 || S.machine || !S.dump.empty();
+}
+
+// Start the next emulated frame: run the play routine, queueing its writes.
+// `exact` says whether the SIDs are being clocked (for the seek snapshot).
+// A CIA-speed frame lasts until the next timer interrupt, so latch rewrites
+// and a second timer made by the play call take effect; cyclesPerFrame
+// stays the play call's cycle budget and the fallback with no timer running.
+static void start_frame(bool exact) {
+    apply_queued_writes(INT_MAX);
+    S.writeCount = 0;
+    S.writeNext = 0;
+    seek_record(exact);
+    if (!S.dump.empty()) {
+        S.remainingCycles += dump_next_frame();
+        S.frameCycles = S.remainingCycles;
+        return;
+    }
+    if (S.machine) {
+        c64_frame();
+        return;
+    }
+    S.deferWrites = true;
+    uint32_t cycles = cpu_jsr(S.playAddress, (uint32_t)S.cyclesPerFrame);
+    S.deferWrites = false;
+    S.stats.playCalls++;
+    S.stats.playCycles += cycles;
+    S.stats.playCyclesMax = std::max(S.stats.playCyclesMax, cycles);
+
+    int frame = S.cyclesPerFrame;
+    if (S.ciaSpeed) {
+        int next = cia_next_irq();
+        if (next != INT_MAX) frame = next;
+    }
+    cia_advance(S.cia, frame);
+    S.remainingCycles += frame;
+    S.frameCycles = S.remainingCycles;
+}
+
+// Full-scale pre-filter voice output (20 bits) maps to about +/-1.
+static const float VOICE_TAP_SCALE = 1.0f / (1 << 19);
+
+static void capture_voice_taps() {
+    if (S.tapCount >= S.tapCapacity) return;
+    for (int chip = 0; chip < S.sidCount; chip++) {
+        for (int v = 0; v < 3; v++) {
+            S.tapBuffer[(chip * 3 + v) * S.tapCapacity + S.tapCount] =
+                S.sid[chip].voice_output(v) * VOICE_TAP_SCALE;
         }
     }
+    S.tapCount++;
+}
 
-    S.remainingCycles = 0;
+// 32 bytes per chip, for up to MAX_SID_CHIPS chips
+static const int REGISTER_FRAME_BYTES = MAX_SID_CHIPS * 32;
+
+// Record the registers the play routine just set (its writes are still
+// queued, but S.memory already holds them) for a frame starting at output
+// sample `sampleIndex`.
+static void capture_register_frame(uint64_t sampleIndex) {
+    if (S.regCount >= S.regCapacity) return;
+    uint8_t* frame = S.regFrames + S.regCount * REGISTER_FRAME_BYTES;
+    memset(frame, 0, REGISTER_FRAME_BYTES);
+    for (int chip = 0; chip < S.sidCount; chip++) {
+        uint8_t* regs = frame + chip * 32;
+        memcpy(regs, &S.memory[S.sidAddress[chip]], 0x19);
+        for (int v = 0; v < 3; v++) {
+            regs[0x1D + v] = S.sid[chip].envelope_level(v);
+        }
+    }
+    S.regFrameSamples[S.regCount++] = (double)sampleIndex;
 }
 
-EMSCRIPTEN_KEEPALIVE
-int audio_generate(int16_t* buffer, int numSamples) {
-    if (!S.loaded || numSamples <= 0) return 0;
+// ---- End-of-tune detection ----
+// Tunes that end go on running their player, usually into silence, so the
+// engine watches for it: output that stays quiet (peak-to-peak under
+// SILENCE_RANGE over each render block) for silenceSeconds, and chips
+// whose voices are all released to zero or whose volume is zero. Optionally
+// (silenceSkip) a silent tune with every voice idle stops clocking reSID:
+// all it would produce is a constant level, so the last sample is held,
+// until a gate goes on or $D418 changes (volume digis).
+
+static bool chips_gates_off() {
+    for (int chip = 0; chip < S.sidCount; chip++) {
+        for (int v = 0; v < 3; v++) {
+            if ((S.memory[S.sidAddress[chip] + v * 7 + 4] & 0x01) || S.sid[chip].envelope_level(v) != 0) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
 
-    int16_t mixBuf[8192];  // scratch buffer for additional SID chips
-    int totalGenerated = 0;
+static bool chips_volume_zero() {
+    for (int chip = 0; chip < S.sidCount; chip++) {
+        if (S.memory[S.sidAddress[chip] + 0x18] & 0x0F) return false;
+    }
+    return true;
+}
+
+static bool output_silent() {
+    return S.quietSamples >= (uint64_t)(S.silenceSeconds * S.sampleRate);
+}
+
+// At a frame start, with this frame's writes queued: start skipping once
+// the tune is silent and idle, stop when a queued write would make sound.
+static void update_skipping() {
+    if (!S.skipping) {
+        if (!output_silent() || !chips_gates_off()) return;
+        S.skipping = true;
+        S.skipPhase = 0.0;
+        for (int chip = 0; chip < S.sidCount; chip++) {
+            S.skipVolume[chip] = S.memory[S.sidAddress[chip] + 0x18];
+        }
+        return;
+    }
+    for (int i = 0; i < S.writeCount; i++) {
+        const auto& w = S.writeQueue[i];
+        bool gateOn = (w.reg == 0x04 || w.reg == 0x0B || w.reg == 0x12) && (w.value & 0x01);
+        if (gateOn || (w.reg == 0x18 && w.value != S.skipVolume[w.chip])) {
+            S.skipping = false;
+            return;
+        }
+    }
+}
+
+// While skipping: the cycles of `segment` that make up to maxSamples held
+// samples, on the sample grid reSID would use. The count goes to generated.
+static int skip_cycles(int segment, int maxSamples, int& generated) {
+    double perSample = S.clockFreq / S.sampleRate;
+    int n = (int)((S.skipPhase + segment) / perSample);
+    if (n <= maxSamples) {
+        generated = n;
+        S.skipPhase += segment - n * perSample;
+        return segment;
+    }
+    generated = maxSamples;
+    int cycles = std::min(segment, (int)std::ceil(maxSamples * perSample - S.skipPhase));
+    S.skipPhase += cycles - maxSamples * perSample;
+    return cycles;
+}
 
-    int loopGuard = 0;
-    const int maxLoops = numSamples + 256;
+// Fold a rendered block into the silence count
+static void track_silence(int16_t* const* out, int generated) {
+    if (generated <= 0) return;
+    bool quiet = true;
+    for (int chip = 0; chip < S.sidCount; chip++) {
+        const int16_t* buf = out[chip];
+        int lo = buf[0], hi = buf[0];
+        for (int s = 1; s < generated; s++) {
+            lo = std::min(lo, (int)buf[s]);
+            hi = std::max(hi, (int)buf[s]);
+        }
+        quiet = quiet && hi - lo < SILENCE_RANGE;
+        S.lastSample[chip] = buf[generated - 1];
+    }
+    S.quietSamples = quiet ? S.quietSamples + generated : 0;
+}
 
-    while (totalGenerated < numSamples && loopGuard++ < maxLoops) {
-        // Run the play routine once per emulated frame.
+// Run the tune and clock every chip for up to numSamples samples, chip N
+// rendering into out[N]. Returns the number of samples produced.
+static int render_chips(int16_t* const* out, int numSamples) {
+    int totalGenerated = 0;
+    int stalls = 0;
+    S.tapCount = 0;
+    S.regCount = 0;
+    double blockStart = now_ms();
+    double cpuMs = 0.0;
+
+    while (totalGenerated < numSamples && stalls < 256) {
+        // Run the play routine once per emulated frame, queueing its writes.
         if (S.remainingCycles <= 0) {
-            if (S.playAddress == 0) break;
-            cpu_jsr(S.playAddress, (uint32_t)S.cyclesPerFrame);
-            S.remainingCycles += S.cyclesPerFrame;
+            if (!has_play()) break;
+            double frameStart = now_ms();
+            start_frame(true);
+            cpuMs += now_ms() - frameStart;
+            if (S.silenceSkip) update_skipping();
+            if (S.regFrames) {
+                capture_register_frame(S.outputSamples + totalGenerated);
+            }
+        }
+
+        // Clock up to the next queued write (or the end of the frame).
+        int framePos = S.frameCycles - S.remainingCycles;
+        apply_queued_writes(framePos);
+        int segment = S.remainingCycles;
+        if (S.writeNext < S.writeCount) {
+            segment = std::min(segment, S.writeQueue[S.writeNext].cycle - framePos);
         }
 
+        // With voice taps on, stop at each tap point to read the voices
         int remaining = numSamples - totalGenerated;
-        reSID::cycle_count delta = S.remainingCycles;
-        int generated = S.sid[0].clock(delta, buffer + totalGenerated, remaining);
-        int cyclesConsumed = S.remainingCycles - delta;
-
-        // Mix any additional SID chips into the same output buffer with saturation.
-        for (int chip = 1; chip < S.sidCount; chip++) {
-            reSID::cycle_count delta2 = cyclesConsumed;
-            int gen2 = S.sid[chip].clock(delta2, mixBuf, generated);
-            for (int s = 0; s < gen2; s++) {
-                int mixed = (int)buffer[totalGenerated + s] + mixBuf[s];
-                if (mixed > 32767) mixed = 32767;
-                if (mixed < -32768) mixed = -32768;
-                buffer[totalGenerated + s] = (int16_t)mixed;
+        if (S.tapBuffer) {
+            remaining = std::min(remaining, S.tapDecimation - S.tapPhase);
+        }
+        int generated, cyclesConsumed;
+        if (S.skipping) {
+            cyclesConsumed = skip_cycles(segment, remaining, generated);
+            for (int chip = 0; chip < S.sidCount; chip++) {
+                std::fill(out[chip] + totalGenerated, out[chip] + totalGenerated + generated, S.lastSample[chip]);
+            }
+        } else {
+            reSID::cycle_count delta = segment;
+            generated = S.sid[0].clock(delta, out[0] + totalGenerated, remaining);
+            cyclesConsumed = segment - delta;
+
+            // Clock the other chips over the same cycles. reSID holds back a
+            // sample that lands exactly on the last cycle given, so when chip 0
+            // stopped on its sample count (cycles left over) the others get one
+            // spare cycle, which they leave unused; when chip 0 ran out of cycles
+            // they get one spare sample slot so the final partial step is clocked.
+            // Either way every chip stays on chip 0's sample grid.
+            bool stoppedOnCount = delta > 0;
+            for (int chip = 1; chip < S.sidCount; chip++) {
+                reSID::cycle_count delta2 = cyclesConsumed + (stoppedOnCount ? 1 : 0);
+                int16_t* dst = out[chip] + totalGenerated;
+                int gen2 = S.sid[chip].clock(delta2, dst, generated + (stoppedOnCount ? 0 : 1));
+                for (int s = gen2; s < generated; s++) {
+                    dst[s] = 0;
+                }
             }
         }
 
-        S.remainingCycles = delta;  // reSID writes leftover cycles back via delta
+        S.remainingCycles -= cyclesConsumed;  // reSID writes leftover cycles back via delta
         totalGenerated += generated;
         S.totalCycles += cyclesConsumed;
+        S.stats.emulatedCycles += cyclesConsumed;
+
+        if (S.tapBuffer) {
+            S.tapPhase += generated;
+            if (S.tapPhase >= S.tapDecimation) {
+                S.tapPhase = 0;
+                capture_voice_taps();
+            }
+        }
 
         // Guard against a zero-progress iteration that could spin forever.
         if (generated == 0 && cyclesConsumed == 0) {
             S.remainingCycles = 0;
+            stalls++;
+            S.stats.stallTrips++;
         }
     }
 
+    S.outputSamples += totalGenerated;
+    track_silence(out, totalGenerated);
+
+    EngineCounters& stats = S.stats;
+    double sidMs = now_ms() - blockStart - cpuMs;
+    stats.blocks++;
+    stats.samples += totalGenerated;
+    stats.cpuMs += cpuMs;
+    stats.sidMs += sidMs;
+    stats.blockCpuMs = cpuMs;
+    stats.blockSidMs = sidMs;
+    stats.blockSamples = totalGenerated;
     return totalGenerated;
 }
 
+// ---- Mixer stage ----
+// Block operations used to combine per-chip buffers. WASM SIMD versions
+// handle 8 samples per step; the scalar tails (and non-SIMD builds) give
+// identical results.
+
+static const int Q15_UNITY = 32768;
+
+static inline int16_t q15_gain(float gain) {
+    int q = (int)lrintf(gain * 32768.0f);
+    return (int16_t)(q > 32767 ? 32767 : (q < 0 ? 0 : q));
+}
+
+static inline int16_t sat16(int v) {
+    return (int16_t)(v > 32767 ? 32767 : (v < -32768 ? -32768 : v));
+}
+
+// Rounding Q15 multiply with saturation, as wasm_i16x8_q15mulr_sat.
+static inline int16_t mul_q15(int16_t v, int16_t q) {
+    return sat16(((int)v * q + 0x4000) >> 15);
+}
+
+// buf *= gain, in place.
+static void mix_scale_i16(int16_t* buf, int n, int16_t gainQ15) {
+    int s = 0;
+#ifdef __wasm_simd128__
+    v128_t g = wasm_i16x8_splat(gainQ15);
+    for (; s + 8 <= n; s += 8) {
+        v128_t v = wasm_v128_load(buf + s);
+        wasm_v128_store(buf + s, wasm_i16x8_q15mulr_sat(v, g));
+    }
+#endif
+    for (; s < n; s++) {
+        buf[s] = mul_q15(buf[s], gainQ15);
+    }
+}
+
+// dst = saturate(dst + src * gain); gainQ15 == Q15_UNITY skips the multiply.
+static void mix_add_i16(int16_t* dst, const int16_t* src, int n, int gainQ15) {
+    int s = 0;
+#ifdef __wasm_simd128__
+    if (gainQ15 == Q15_UNITY) {
+        for (; s + 8 <= n; s += 8) {
+            v128_t v = wasm_i16x8_add_sat(wasm_v128_load(dst + s), wasm_v128_load(src + s));
+            wasm_v128_store(dst + s, v);
+        }
+    } else {
+        v128_t g = wasm_i16x8_splat((int16_t)gainQ15);
+        for (; s + 8 <= n; s += 8) {
+            v128_t v = wasm_i16x8_q15mulr_sat(wasm_v128_load(src + s), g);
+            wasm_v128_store(dst + s, wasm_i16x8_add_sat(wasm_v128_load(dst + s), v));
+        }
+    }
+#endif
+    for (; s < n; s++) {
+        int v = gainQ15 == Q15_UNITY ? src[s] : mul_q15(src[s], (int16_t)gainQ15);
+        dst[s] = sat16(dst[s] + v);
+    }
+}
+
+// left/right (+)= src * gainLeft/gainRight. With accumulate false the
+// outputs are overwritten, which saves clearing them first.
+static void mix_pan_f32(float* left, float* right, const int16_t* src, int n,
+                        float gainLeft, float gainRight, bool accumulate) {
+    int s = 0;
+#ifdef __wasm_simd128__
+    v128_t gl = wasm_f32x4_splat(gainLeft);
+    v128_t gr = wasm_f32x4_splat(gainRight);
+    for (; s + 8 <= n; s += 8) {
+        v128_t v = wasm_v128_load(src + s);
+        v128_t lo = wasm_f32x4_convert_i32x4(wasm_i32x4_extend_low_i16x8(v));
+        v128_t hi = wasm_f32x4_convert_i32x4(wasm_i32x4_extend_high_i16x8(v));
+        v128_t l0 = wasm_f32x4_mul(lo, gl), l1 = wasm_f32x4_mul(hi, gl);
+        v128_t r0 = wasm_f32x4_mul(lo, gr), r1 = wasm_f32x4_mul(hi, gr);
+        if (accumulate) {
+            l0 = wasm_f32x4_add(l0, wasm_v128_load(left + s));
+            l1 = wasm_f32x4_add(l1, wasm_v128_load(left + s + 4));
+            r0 = wasm_f32x4_add(r0, wasm_v128_load(right + s));
+            r1 = wasm_f32x4_add(r1, wasm_v128_load(right + s + 4));
+        }
+        wasm_v128_store(left + s, l0);
+        wasm_v128_store(left + s + 4, l1);
+        wasm_v128_store(right + s, r0);
+        wasm_v128_store(right + s + 4, r1);
+    }
+#endif
+    for (; s < n; s++) {
+        float v = src[s];
+        left[s] = (accumulate ? left[s] : 0.0f) + v * gainLeft;
+        right[s] = (accumulate ? right[s] : 0.0f) + v * gainRight;
+    }
+}
+
+static void mix_clamp_f32(float* buf, int n) {
+    int s = 0;
+#ifdef __wasm_simd128__
+    v128_t one = wasm_f32x4_splat(1.0f), minusOne = wasm_f32x4_splat(-1.0f);
+    for (; s + 4 <= n; s += 4) {
+        v128_t v = wasm_v128_load(buf + s);
+        wasm_v128_store(buf + s, wasm_f32x4_min(wasm_f32x4_max(v, minusOne), one));
+    }
+#endif
+    for (; s < n; s++) {
+        buf[s] = buf[s] > 1.0f ? 1.0f : (buf[s] < -1.0f ? -1.0f : buf[s]);
+    }
+}
+
+// ---- Quality governor ----
+// Live output (audio_generate / audio_generate_f32) is timed against the
+// audio it produces. With the governor on, a smoothed load above
+// GOVERNOR_DOWN_LOAD steps the sampling method down (resample ->
+// interpolate -> fast) so playback degrades instead of underrunning; a long
+// stretch below GOVERNOR_UP_LOAD steps it back up, never past the method
+// chosen with audio_set_sampling_method. After each step the load is given
+// GOVERNOR_HOLD to settle before the next.
+
+static void apply_sampling_method(int method) {
+    reSID::sampling_method m;
+    switch (method) {
+        case 1:  m = reSID::SAMPLE_INTERPOLATE; break;
+        case 2:  m = reSID::SAMPLE_RESAMPLE; break;
+        default: m = reSID::SAMPLE_FAST; method = 0; break;
+    }
+    for (int i = 0; i < S.sidCount; i++) {
+        S.sid[i].set_sampling_parameters(S.clockFreq, m, S.sampleRate);
+    }
+    S.samplingMethod = method;
+}
+
+static void governor_update(double renderMs, int generated) {
+    if (generated <= 0) return;
+    double seconds = generated / S.sampleRate;
+    double load = renderMs / 1000.0 / seconds;
+    S.renderLoad += (load - S.renderLoad) * std::min(1.0, seconds / GOVERNOR_SMOOTHING);
+
+    if (!S.governorOn) return;
+    if (S.governorHold > 0.0) {
+        S.governorHold -= seconds;
+        return;
+    }
+    if (S.renderLoad > GOVERNOR_DOWN_LOAD && S.samplingMethod > 0) {
+        apply_sampling_method(S.samplingMethod - 1);
+        S.governorHold = GOVERNOR_HOLD;
+        S.governorCalm = 0.0;
+    } else if (S.renderLoad < GOVERNOR_UP_LOAD && S.samplingMethod < S.methodCeiling) {
+        S.governorCalm += seconds;
+        if (S.governorCalm >= GOVERNOR_UP_AFTER) {
+            apply_sampling_method(S.samplingMethod + 1);
+            S.governorHold = GOVERNOR_HOLD;
+            S.governorCalm = 0.0;
+        }
+    } else {
+        S.governorCalm = 0.0;
+    }
+}
+
+// Mono int16 output: chip 0 renders straight into the caller's buffer and
+// any further chips are mixed in with saturation.
+EMSCRIPTEN_KEEPALIVE
+int audio_generate(int16_t* buffer, int numSamples) {
+    if (!S.loaded || numSamples <= 0) return 0;
+    double start = now_ms();
+
+    reserve_chip_buffers(numSamples);
+    int16_t* out[MAX_SID_CHIPS] = { buffer };
+    for (int chip = 1; chip < S.sidCount; chip++) {
+        out[chip] = S.chipBuffer[chip].data();
+    }
+
+    int generated = render_chips(out, numSamples);
+
+    if (S.chipGain[0] < 1.0f) {
+        mix_scale_i16(buffer, generated, q15_gain(S.chipGain[0]));
+    }
+    for (int chip = 1; chip < S.sidCount; chip++) {
+        int gain = S.chipGain[chip] < 1.0f ? q15_gain(S.chipGain[chip]) : Q15_UNITY;
+        mix_add_i16(buffer, out[chip], generated, gain);
+    }
+
+    governor_update(now_ms() - start, generated);
+    return generated;
+}
+
+// Planar float stereo output in [-1, 1], each chip placed by its pan
+// setting (see audio_set_chip_pan). Saves the caller an int16 conversion.
+EMSCRIPTEN_KEEPALIVE
+int audio_generate_f32(float* left, float* right, int numSamples) {
+    if (!S.loaded || numSamples <= 0) return 0;
+    double start = now_ms();
+
+    reserve_chip_buffers(numSamples);
+    int16_t* out[MAX_SID_CHIPS] = {};
+    for (int chip = 0; chip < S.sidCount; chip++) {
+        out[chip] = S.chipBuffer[chip].data();
+    }
+
+    int generated = render_chips(out, numSamples);
+
+    // Balance law: centre feeds both sides at full level (same loudness as
+    // the mono mix), fully left/right silences the other side.
+    for (int chip = 0; chip < S.sidCount; chip++) {
+        float pan = S.chipPan[chip];
+        float scale = S.chipGain[chip] / 32768.0f;
+        float gainLeft = (pan > 0.0f ? 1.0f - pan : 1.0f) * scale;
+        float gainRight = (pan < 0.0f ? 1.0f + pan : 1.0f) * scale;
+        mix_pan_f32(left, right, out[chip], generated, gainLeft, gainRight, chip > 0);
+    }
+    mix_clamp_f32(left, generated);
+    mix_clamp_f32(right, generated);
+
+    governor_update(now_ms() - start, generated);
+    return generated;
+}
+
+// Scratch for the incoming instance of a crossfade
+ENGINE_STATE std::vector<float> g_fadeLeft, g_fadeRight;
+
+// Render numSamples from instances `from` and `to` (handles) as planar float
+// stereo and mix them with an equal-power crossfade whose position runs
+// from fadeStart to fadeEnd across the block: 0 = only `from`, 1 = only
+// `to`. An instance whose gain is 0 for the whole block isn't rendered (so
+// it doesn't advance), which makes a block at 0 or 1 plain playback of one
+// tune. Missing output (nothing loaded, tune ended) is silence. Returns
+// numSamples, or -1 for a bad handle; the selection is unchanged.
+EMSCRIPTEN_KEEPALIVE
+int audio_crossfade_f32(int from, int to, float* left, float* right, int numSamples,
+                        double fadeStart, double fadeEnd) {
+    if (numSamples <= 0) return 0;
+    EngineState* selected = g_engine;
+    if (from == to || audio_select(from) != 0 || audio_select(to) != 0) {
+        g_engine = selected;
+        return -1;
+    }
+
+    fadeStart = std::min(1.0, std::max(0.0, fadeStart));
+    fadeEnd = std::min(1.0, std::max(0.0, fadeEnd));
+    bool renderFrom = fadeStart < 1.0 || fadeEnd < 1.0;
+    bool renderTo = fadeStart > 0.0 || fadeEnd > 0.0;
+
+    int generated = 0;
+    if (renderFrom) {
+        audio_select(from);
+        generated = std::max(audio_generate_f32(left, right, numSamples), 0);
+    }
+    std::fill(left + generated, left + numSamples, 0.0f);
+    std::fill(right + generated, right + numSamples, 0.0f);
+
+    if (renderTo) {
+        if ((int)g_fadeLeft.size() < numSamples) {
+            g_fadeLeft.resize(numSamples);
+            g_fadeRight.resize(numSamples);
+        }
+        audio_select(to);
+        int generatedTo = std::max(audio_generate_f32(g_fadeLeft.data(), g_fadeRight.data(), numSamples), 0);
+        std::fill(g_fadeLeft.begin() + generatedTo, g_fadeLeft.begin() + numSamples, 0.0f);
+        std::fill(g_fadeRight.begin() + generatedTo, g_fadeRight.begin() + numSamples, 0.0f);
+
+        const double halfPi = 1.5707963267948966;
+        double step = (fadeEnd - fadeStart) / numSamples;
+        for (int s = 0; s < numSamples; s++) {
+            double position = fadeStart + step * (s + 0.5);
+            float gainFrom = (float)std::cos(position * halfPi);
+            float gainTo = (float)std::sin(position * halfPi);
+            left[s] = left[s] * gainFrom + g_fadeLeft[s] * gainTo;
+            right[s] = right[s] * gainFrom + g_fadeRight[s] * gainTo;
+        }
+    }
+
+    g_engine = selected;
+    return numSamples;
+}
+
+// ---- Voice taps ----
+// Per-voice output for oscilloscope views, taken in the same clocking pass
+// as the mix: every `decimation` output samples, the pre-filter output of
+// each voice of each chip goes into `buffer`, planar, voice v of chip c at
+// buffer[(c * 3 + v) * capacity + i] (so 3 * chips * capacity floats).
+// Values are about -1..1 and carry the chip's DC offset. Each
+// audio_generate / audio_generate_f32 call writes from i = 0;
+// audio_get_voice_tap_count says how many. A null buffer turns taps off.
+// reSID filters the mixed voices, so there is no per-voice post-filter
+// signal to tap.
+EMSCRIPTEN_KEEPALIVE
+void audio_set_voice_taps(float* buffer, int capacity, int decimation) {
+    S.tapBuffer = capacity > 0 ? buffer : nullptr;
+    S.tapCapacity = S.tapBuffer ? capacity : 0;
+    S.tapDecimation = decimation > 0 ? decimation : 1;
+    S.tapPhase = 0;
+    S.tapCount = 0;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int audio_get_voice_tap_count() { return S.tapCount; }
+
+// ---- Register stream ----
+// For visualizers that follow the notes rather than the waveform. Each play
+// frame rendered by audio_generate / audio_generate_f32 adds one record:
+// REGISTER_FRAME_BYTES (96) bytes to `regs`, 32 per chip - $00-$18 as the
+// play routine left them, $1D-$1F the envelope levels of voices 1-3, the
+// rest 0 - and to `sampleIndex` the output sample the frame starts at,
+// counted from audio_init. Up to `capacity` frames per call, written from
+// the start of the buffers; audio_get_register_frame_count says how many.
+// Null buffers turn the stream off.
+EMSCRIPTEN_KEEPALIVE
+void audio_set_register_stream(uint8_t* regs, double* sampleIndex, int capacity) {
+    bool on = regs && sampleIndex && capacity > 0;
+    S.regFrames = on ? regs : nullptr;
+    S.regFrameSamples = on ? sampleIndex : nullptr;
+    S.regCapacity = on ? capacity : 0;
+    S.regCount = 0;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int audio_get_register_frame_count() { return S.regCount; }
+
+// Output level of one chip, 0..1, for both output paths. Reset to 1
+// whenever a tune is loaded.
+EMSCRIPTEN_KEEPALIVE
+void audio_set_chip_gain(int chip, float gain) {
+    if (chip < 0 || chip >= MAX_SID_CHIPS) return;
+    S.chipGain[chip] = gain < 0.0f ? 0.0f : (gain > 1.0f ? 1.0f : gain);
+}
+
+// Stereo position of one chip for audio_generate_f32: -1 = left, 0 = centre,
+// 1 = right. Reset to a default spread whenever a tune is loaded.
+EMSCRIPTEN_KEEPALIVE
+void audio_set_chip_pan(int chip, float pan) {
+    if (chip < 0 || chip >= MAX_SID_CHIPS) return;
+    S.chipPan[chip] = pan < -1.0f ? -1.0f : (pan > 1.0f ? 1.0f : pan);
+}
+
 EMSCRIPTEN_KEEPALIVE
 void audio_set_model(int model) {
     S.chipModel = model;
@@ -952,17 +2756,543 @@ void audio_set_model(int model) {
 
 EMSCRIPTEN_KEEPALIVE
 void audio_set_sampling_method(int method) {
-    reSID::sampling_method m;
-    switch (method) {
-        case 1:  m = reSID::SAMPLE_INTERPOLATE; break;
-        case 2:  m = reSID::SAMPLE_RESAMPLE; break;
-        default: m = reSID::SAMPLE_FAST; break;
+    apply_sampling_method(method);
+    S.methodCeiling = S.samplingMethod;
+    S.governorHold = GOVERNOR_HOLD;
+    S.governorCalm = 0.0;
+}
+
+// With the governor on, live output may run below the chosen sampling
+// method while the render load is too high for it. Off by default, so
+// output only depends on the settings.
+EMSCRIPTEN_KEEPALIVE
+void audio_set_quality_governor(int enabled) {
+    S.governorOn = enabled != 0;
+    if (!S.governorOn && S.samplingMethod != S.methodCeiling) {
+        apply_sampling_method(S.methodCeiling);
     }
+    S.governorHold = GOVERNOR_HOLD;
+    S.governorCalm = 0.0;
+}
+
+// Sampling method in effect (0 fast, 1 interpolate, 2 resample)
+EMSCRIPTEN_KEEPALIVE
+int audio_get_sampling_method() { return S.samplingMethod; }
+
+// Smoothed fraction of real time spent rendering live output; 1 - this is
+// the headroom
+EMSCRIPTEN_KEEPALIVE
+double audio_get_render_load() { return S.renderLoad; }
+
+// Copy the instance's playback counters (see AudioStats) to `out`, which
+// may be null, and clear them if `reset` is set. They count from
+// audio_init or the last reset, across tune loads. Render time is split
+// between play calls (6510) and the rest (reSID), for all rendering and
+// for the last render call. Play-call counts include the play calls seeks
+// run. Returns AUDIO_STATS_FIELDS.
+EMSCRIPTEN_KEEPALIVE
+int audio_get_stats(AudioStats* out, int reset) {
+    const EngineCounters& c = S.stats;
+    if (out) {
+        out->emulatedCycles = (double)c.emulatedCycles;
+        out->samples = (double)c.samples;
+        out->blocks = (double)c.blocks;
+        out->playCalls = (double)c.playCalls;
+        out->playCyclesAvg = c.playCalls ? (double)c.playCycles / c.playCalls : 0.0;
+        out->playCyclesMax = c.playCyclesMax;
+        out->guardTrips = (double)c.guardTrips;
+        out->guardCycles = (double)c.guardCycles;
+        out->stallTrips = (double)c.stallTrips;
+        out->cpuMs = c.cpuMs;
+        out->sidMs = c.sidMs;
+        out->blockCpuMs = c.blockCpuMs;
+        out->blockSidMs = c.blockSidMs;
+        out->blockSamples = c.blockSamples;
+    }
+    if (reset) S.stats = {};
+    return AUDIO_STATS_FIELDS;
+}
+
+// ---- Offline rendering ----
+// Renders the loaded tune to a WAV byte stream as fast as the emulation
+// runs, pulled in caller-sized chunks so memory stays bounded however long
+// the render is. Select the subtune (audio_set_subtune) and sampling method
+// first, then call audio_render_begin and audio_render until it returns 0.
+
+enum RenderFormat {
+    RENDER_PCM16_MONO   = 0,
+    RENDER_PCM16_STEREO = 1,
+    RENDER_FLOAT_STEREO = 2,
+};
+
+static int render_channels() { return S.renderFormat == RENDER_PCM16_MONO ? 1 : 2; }
+static int render_frame_bytes() { return render_channels() * (S.renderFormat == RENDER_FLOAT_STEREO ? 4 : 2); }
+
+// Float WAVs need the extended fmt chunk and a fact chunk.
+static int render_header_bytes() { return S.renderFormat == RENDER_FLOAT_STEREO ? 58 : 44; }
+
+static inline uint8_t* put_le16(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8);
+    return p + 2;
+}
+
+static inline uint8_t* put_le32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24);
+    return p + 4;
+}
+
+static uint8_t* put_tag(uint8_t* p, const char* tag) {
+    memcpy(p, tag, 4);
+    return p + 4;
+}
+
+static void write_wav_header(uint8_t* p) {
+    const bool isFloat = S.renderFormat == RENDER_FLOAT_STEREO;
+    const uint32_t channels = render_channels();
+    const uint32_t frameBytes = render_frame_bytes();
+    const uint32_t rate = (uint32_t)lrint(S.sampleRate);
+    const uint32_t dataBytes = S.renderTotalFrames * frameBytes;
+
+    p = put_tag(p, "RIFF");
+    p = put_le32(p, render_header_bytes() - 8 + dataBytes);
+    p = put_tag(p, "WAVE");
+    p = put_tag(p, "fmt ");
+    p = put_le32(p, isFloat ? 18 : 16);
+    p = put_le16(p, isFloat ? 3 : 1);           // IEEE float / PCM
+    p = put_le16(p, channels);
+    p = put_le32(p, rate);
+    p = put_le32(p, rate * frameBytes);
+    p = put_le16(p, frameBytes);
+    p = put_le16(p, isFloat ? 32 : 16);
+    if (isFloat) {
+        p = put_le16(p, 0);                     // cbSize
+        p = put_tag(p, "fact");
+        p = put_le32(p, 4);
+        p = put_le32(p, S.renderTotalFrames);
+    }
+    p = put_tag(p, "data");
+    put_le32(p, dataBytes);
+}
+
+static inline int16_t float_to_pcm16(float v) {
+    int i = (int)lrintf(v * 32767.0f);
+    return (int16_t)(i > 32767 ? 32767 : (i < -32768 ? -32768 : i));
+}
+
+// Start an offline render of `seconds` of the current subtune.
+// format: 0 = 16-bit mono, 1 = 16-bit stereo, 2 = 32-bit float stereo.
+// The last fadeSeconds fade linearly to silence.
+// Returns the total WAV size in bytes, or -1 if no tune is loaded, -2 for
+// a bad format, -3 for a bad length (zero, or over the 4 GB WAV limit).
+EMSCRIPTEN_KEEPALIVE
+double audio_render_begin(double seconds, int format, double fadeSeconds) {
+    S.renderActive = false;
+    if (!S.loaded) return -1;
+    if (format < RENDER_PCM16_MONO || format > RENDER_FLOAT_STEREO) return -2;
+
+    S.renderFormat = format;
+    double frames = floor(seconds * S.sampleRate);
+    double maxFrames = (double)(0xFFFFFFFFu - (uint32_t)render_header_bytes()) / render_frame_bytes();
+    if (!(frames >= 1.0) || frames > maxFrames) return -3;
+
+    S.renderTotalFrames = (uint32_t)frames;
+    S.renderDoneFrames = 0;
+    double fade = fadeSeconds > 0.0 ? floor(fadeSeconds * S.sampleRate) : 0.0;
+    S.renderFadeFrames = (uint32_t)std::min(fade, frames);
+    S.renderHeaderPending = true;
+    S.renderActive = true;
+
+    if (S.renderFormat == RENDER_PCM16_MONO) {
+        S.renderMono.resize(RENDER_BLOCK);
+    } else {
+        S.renderLeft.resize(RENDER_BLOCK);
+        S.renderRight.resize(RENDER_BLOCK);
+    }
+
+    return render_header_bytes() + (double)S.renderTotalFrames * render_frame_bytes();
+}
+
+// Fill `out` with the next part of the WAV stream (the header comes first).
+// Returns the bytes written, 0 once the render is complete (or if none was
+// started), or -1 if capacity can't hold the header or one frame.
+EMSCRIPTEN_KEEPALIVE
+int audio_render(uint8_t* out, int capacity) {
+    if (!S.renderActive) return 0;
+
+    int written = 0;
+    if (S.renderHeaderPending) {
+        if (capacity < render_header_bytes()) return -1;
+        write_wav_header(out);
+        written = render_header_bytes();
+        S.renderHeaderPending = false;
+    }
+
+    const int frameBytes = render_frame_bytes();
+    const uint32_t fadeStart = S.renderTotalFrames - S.renderFadeFrames;
+    if (written == 0 && capacity < frameBytes) return -1;
+
+    while (S.renderDoneFrames < S.renderTotalFrames && capacity - written >= frameBytes) {
+        int n = std::min((uint32_t)RENDER_BLOCK, S.renderTotalFrames - S.renderDoneFrames);
+        n = std::min(n, (capacity - written) / frameBytes);
+
+        // A tune that stops producing (no play routine) pads with silence
+        // so the stream always matches the size promised in the header.
+        int got;
+        if (S.renderFormat == RENDER_PCM16_MONO) {
+            got = audio_generate(S.renderMono.data(), n);
+            std::fill(S.renderMono.begin() + got, S.renderMono.begin() + n, 0);
+        } else {
+            got = audio_generate_f32(S.renderLeft.data(), S.renderRight.data(), n);
+            std::fill(S.renderLeft.begin() + got, S.renderLeft.begin() + n, 0.0f);
+            std::fill(S.renderRight.begin() + got, S.renderRight.begin() + n, 0.0f);
+        }
+
+        uint8_t* p = out + written;
+        for (int i = 0; i < n; i++) {
+            uint32_t frame = S.renderDoneFrames + i;
+            float gain = frame < fadeStart ? 1.0f
+                : (float)(S.renderTotalFrames - frame) / (float)S.renderFadeFrames;
+
+            if (S.renderFormat == RENDER_PCM16_MONO) {
+                int16_t v = S.renderMono[i];
+                if (gain < 1.0f) v = (int16_t)lrintf(v * gain);
+                p = put_le16(p, (uint16_t)v);
+            } else if (S.renderFormat == RENDER_PCM16_STEREO) {
+                p = put_le16(p, (uint16_t)float_to_pcm16(S.renderLeft[i] * gain));
+                p = put_le16(p, (uint16_t)float_to_pcm16(S.renderRight[i] * gain));
+            } else {
+                float l = S.renderLeft[i] * gain, r = S.renderRight[i] * gain;
+                uint32_t bits;
+                memcpy(&bits, &l, 4); p = put_le32(p, bits);
+                memcpy(&bits, &r, 4); p = put_le32(p, bits);
+            }
+        }
+
+        written += n * frameBytes;
+        S.renderDoneFrames += n;
+    }
+
+    if (S.renderDoneFrames == S.renderTotalFrames) {
+        S.renderActive = false;
+    }
+    return written;
+}
+
+// ---- Seeking ----
+// A seek restores the latest snapshot at or before the target and catches
+// up from there: play calls only ("CPU-only", the SIDs untouched) to within
+// SEEK_SETTLE of the target, then the SIDs are loaded with the registers the
+// tune last wrote and clocked, without producing samples, the rest of the
+// way so envelopes and filter settle. Snapshots taken during playback hold
+// the SIDs too; if one is within SEEK_SETTLE the CPU-only step is skipped.
+// Snapshots are recorded by playback, by seeks and by audio_seek_prepare,
+// which builds the index ahead so even a first seek is quick.
+
+// Play calls only, up to the last frame boundary before targetCycles.
+static void fast_forward_cpu(uint64_t targetCycles) {
+    S.cpuOnly = true;
+    while (S.totalCycles + S.cyclesPerFrame <= targetCycles) {
+        start_frame(false);
+        S.totalCycles += S.remainingCycles;
+        S.remainingCycles = 0;
+    }
+    S.cpuOnly = false;
+}
+
+// Load every SID with the register values the tune last wrote (kept in
+// S.memory), keeping the rest of its state.
+static void sync_sid_registers() {
     for (int i = 0; i < S.sidCount; i++) {
-        S.sid[i].set_sampling_parameters(S.clockFreq, m, S.sampleRate);
+        reSID::SID::State state = S.sid[i].read_state();
+        memcpy(state.sid_register, &S.memory[S.sidAddress[i]], 0x19);
+        S.sid[i].write_state(state);
+    }
+}
+
+// Full emulation, SIDs clocked without sampling, up to targetCycles.
+static void fast_forward_exact(uint64_t targetCycles) {
+    while (S.totalCycles < targetCycles) {
+        if (S.remainingCycles <= 0) {
+            if (!has_play()) break;
+            start_frame(true);
+            continue;
+        }
+
+        int framePos = S.frameCycles - S.remainingCycles;
+        apply_queued_writes(framePos);
+        int segment = S.remainingCycles;
+        if (S.writeNext < S.writeCount) {
+            segment = std::min(segment, S.writeQueue[S.writeNext].cycle - framePos);
+        }
+        segment = (int)std::min<uint64_t>(segment, targetCycles - S.totalCycles);
+
+        for (int chip = 0; chip < S.sidCount; chip++) {
+            S.sid[chip].clock(segment);
+        }
+        S.remainingCycles -= segment;
+        S.totalCycles += segment;
+    }
+}
+
+// Latest snapshot at or before targetCycles (slot 0 always exists).
+static const SeekSnapshot& seek_find(uint64_t targetCycles) {
+    size_t slot = targetCycles > S.seekOrigin
+        ? (size_t)((targetCycles - S.seekOrigin) / S.seekInterval) : 0;
+    slot = std::min(slot, S.seekSlots.size() - 1);
+    while (slot > 0 && (!S.seekSlots[slot].valid || S.seekSlots[slot].totalCycles > targetCycles)) {
+        slot--;
+    }
+    return S.seekSlots[slot];
+}
+
+// Jump to `seconds` of play time (as audio_get_play_time counts it) in the
+// current subtune. Returns the new play time, or -1 if no subtune is
+// running, -2 if the tune has no play routine to run.
+EMSCRIPTEN_KEEPALIVE
+double audio_seek(double seconds) {
+    if (!S.loaded || S.seekSlots.empty()) return -1;
+    if (!has_play()) return -2;
+
+    uint64_t target = seconds > 0.0 ? (uint64_t)(seconds * S.clockFreq) : 0;
+    uint64_t settle = (uint64_t)(SEEK_SETTLE * S.clockFreq);
+
+    // Catching up records snapshots, which can move this one
+    const SeekSnapshot& snap = seek_find(target);
+    const bool exact = snap.exact;
+    const uint64_t from = snap.totalCycles;
+    target = std::max(target, from);
+    seek_restore(snap, true);
+
+    if (!exact || target - from > settle) {
+        if (target - from > settle) {
+            fast_forward_cpu(target - settle);
+        }
+        sync_sid_registers();
+    }
+    fast_forward_exact(target);
+    silence_reset();
+
+    return (double)S.totalCycles / S.clockFreq;
+}
+
+// Extend the seek index towards untilSeconds by CPU-only fast-forward,
+// covering at most maxSeconds of play time per call so the work can be
+// spread out. The playback position and the SIDs are left as they were.
+// Returns the play time indexed so far; it stops growing once the index
+// is complete or its memory budget is used up.
+EMSCRIPTEN_KEEPALIVE
+double audio_seek_prepare(double untilSeconds, double maxSeconds) {
+    if (!S.loaded || S.seekSlots.empty()) return -1;
+
+    const SeekSnapshot& last = S.seekSlots.back();  // not used once the index grows
+    uint64_t until = (uint64_t)(std::max(untilSeconds, 0.0) * S.clockFreq);
+    uint64_t limit = last.totalCycles + (uint64_t)(std::max(maxSeconds, 0.0) * S.clockFreq);
+    if (has_play() && last.valid && last.totalCycles < until) {
+        // Save the live machine; the SIDs aren't touched in CPU-only mode
+        std::vector<uint8_t> memory(S.memory, S.memory + sizeof(S.memory));
+        std::vector<uint8_t> queue((const uint8_t*)S.writeQueue,
+                                   (const uint8_t*)(S.writeQueue + S.writeCount));
+        uint16_t pc = S.pc;
+        uint8_t sp = S.sp, a = S.a, x = S.x, y = S.y, st = S.st;
+        CIAState cia = S.cia;
+        MiniC64 c64 = S.c64;
+        DumpCursor dumpCursor = S.dumpCursor;
+        uint64_t totalCycles = S.totalCycles;
+        int remainingCycles = S.remainingCycles, frameCycles = S.frameCycles;
+        int writeNext = S.writeNext;
+
+        seek_restore(last, false);
+        fast_forward_cpu(std::min(until, limit));
+
+        memcpy(S.memory, memory.data(), sizeof(S.memory));
+        memcpy(S.writeQueue, queue.data(), queue.size());
+        S.writeCount = (int)(queue.size() / sizeof(S.writeQueue[0]));
+        S.writeNext = writeNext;
+        S.pc = pc; S.sp = sp; S.a = a; S.x = x; S.y = y; S.st = st;
+        S.cia = cia;
+        S.c64 = c64;
+        S.dumpCursor = dumpCursor;
+        S.totalCycles = totalCycles;
+        S.remainingCycles = remainingCycles;
+        S.frameCycles = frameCycles;
+    }
+
+    return (double)S.seekSlots.back().totalCycles / S.clockFreq;
+}
+
+// Seconds between seek snapshots (default 1). Clears the index, apart from
+// the start of the subtune.
+EMSCRIPTEN_KEEPALIVE
+void audio_set_seek_interval(double seconds) {
+    if (seconds <= 0.0) return;
+    S.seekInterval = std::max<uint64_t>(1, (uint64_t)(seconds * S.clockFreq));
+    if (S.seekSlots.empty()) return;
+
+    SeekSnapshot start = S.seekSlots[0];
+    S.seekSlots.assign(1, start);
+    S.seekBytes = start.pages.size();
+}
+
+// ---- Register dump capture ----
+
+// Hash of everything the coming play calls depend on: RAM (which holds the
+// SID register values too), the CPU registers and the CIA timers, and for
+// the mini-C64 its interrupt state and CIA 2 too.
+static uint64_t machine_state_hash() {
+    uint64_t h = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < sizeof(S.memory); i += 8) {
+        uint64_t word;
+        memcpy(&word, S.memory + i, 8);
+        h = (h ^ word) * 0x9E3779B97F4A7C15ull;
+        h ^= h >> 32;
+    }
+    uint32_t regs[8] = { S.pc, S.sp, S.a, S.x, S.y, S.st, S.cia.irqMask, 0 };
+    h = fnv1a64((const uint8_t*)regs, sizeof(regs), h);
+    for (const CIATimer& t : S.cia.timer) {
+        int timer[3] = { t.latch, t.control, cia_running(t) ? t.underflow : t.counter };
+        h = fnv1a64((const uint8_t*)timer, sizeof(timer), h);
+    }
+    if (S.machine) {
+        const MiniC64& m = S.c64;
+        int state[8] = { S.cia.flags, m.cia2.irqMask, m.cia2.flags, m.rasterCompare,
+                         m.vicIrqFlags | (m.vicIrqMask << 8), m.carry, m.nmiLine, m.nmiPending };
+        h = fnv1a64((const uint8_t*)state, sizeof(state), h);
+        for (const CIATimer& t : m.cia2.timer) {
+            int timer[3] = { t.latch, t.control, cia_running(t) ? t.underflow : t.counter };
+            h = fnv1a64((const uint8_t*)timer, sizeof(timer), h);
+        }
     }
+    return h;
 }
 
+static void put_varint(std::vector<uint8_t>& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+}
+
+// Record the current subtune, from its start, as a register dump (see
+// "Register dumps"): until its state repeats, making a loop, or for
+// maxSeconds of play time (<= 0: DUMP_DEFAULT_SECONDS). The SIDs are
+// clocked throughout so tunes that read them behave as in playback; writes
+// beyond MAX_QUEUED_WRITES in one play call aren't recorded. The subtune
+// is restarted afterwards. Returns the dump's size in bytes (see
+// audio_dump_data), -1 if no SID tune is loaded or -2 if it has no play
+// routine.
+EMSCRIPTEN_KEEPALIVE
+int audio_dump_capture(double maxSeconds) {
+    if (!S.loaded || !S.dump.empty()) return -1;
+    audio_set_subtune(S.currentSubtune);
+    if (!has_play()) return -2;
+
+    // The init routine's writes; set_subtune cached them unless there were
+    // too many, in which case they're still in initLog
+    const InitSnapshot* cached = init_cache_find(init_cache_key(S.currentSubtune));
+    const std::vector<InitSIDAccess>& initLog = cached ? cached->sidLog : S.initLog;
+
+    std::vector<uint8_t>& out = S.dumpCapture;
+    out.assign(DUMP_HEADER_BYTES, 0);
+    int shadow[MAX_SID_CHIPS][32];  // register values as written, -1: not yet
+    std::fill(&shadow[0][0], &shadow[0][0] + MAX_SID_CHIPS * 32, -1);
+    uint32_t initWrites = 0;
+    for (const auto& access : initLog) {
+        if (!access.write) continue;
+        out.push_back((uint8_t)(access.chip << 5 | access.reg));
+        out.push_back(access.value);
+        shadow[access.chip][access.reg] = access.value;
+        initWrites++;
+    }
+
+    // Run the frames, keeping the writes that change a register
+    struct Frame {
+        int      length;
+        uint32_t first, count;
+    };
+    std::vector<Frame> frames;
+    std::vector<EngineState::QueuedWrite> writes;
+    std::unordered_map<uint64_t, uint32_t> seen;  // state hash -> frame
+    uint32_t loopFrame = DUMP_NO_LOOP;
+    uint64_t limit = (uint64_t)((maxSeconds > 0.0 ? maxSeconds : DUMP_DEFAULT_SECONDS) * S.clockFreq);
+    for (uint64_t captured = 0; captured < limit; ) {
+        auto known = seen.emplace(machine_state_hash(), (uint32_t)frames.size());
+        if (!known.second) {
+            loopFrame = known.first->second;
+            break;
+        }
+
+        int before = S.remainingCycles;
+        start_frame(true);
+        Frame frame = { S.remainingCycles - before, (uint32_t)writes.size(), 0 };
+        for (int i = 0; i < S.writeCount; i++) {
+            const auto& w = S.writeQueue[i];
+            if (shadow[w.chip][w.reg] == w.value) continue;
+            shadow[w.chip][w.reg] = w.value;
+            writes.push_back(w);
+            frame.count++;
+        }
+        frames.push_back(frame);
+        captured += frame.length;
+        fast_forward_exact(S.totalCycles + S.remainingCycles);
+    }
+
+    // Encode them
+    uint32_t loopOffset = 0;
+    int lastLength = -1;
+    size_t run = 0;  // offset of the open empty run, 0: none
+    for (uint32_t i = 0; i < frames.size(); i++) {
+        const Frame& frame = frames[i];
+        bool setLength = frame.length != lastLength || i == loopFrame;
+        if (frame.count == 0 && !setLength) {
+            if (run && (out[run] & 0x7F) < 0x7F) {
+                out[run]++;
+            } else {
+                run = out.size();
+                out.push_back(0x80);
+            }
+            continue;
+        }
+
+        run = 0;
+        if (i == loopFrame) loopOffset = (uint32_t)out.size();
+        out.push_back((uint8_t)((setLength ? 0x40 : 0) | std::min<uint32_t>(frame.count, 0x3F)));
+        if (frame.count >= 0x3F) put_varint(out, frame.count - 0x3F);
+        if (setLength) put_varint(out, (uint32_t)frame.length);
+        lastLength = frame.length;
+
+        int cycle = 0;
+        for (uint32_t k = 0; k < frame.count; k++) {
+            const auto& w = writes[frame.first + k];
+            out.push_back((uint8_t)(w.chip << 5 | w.reg));
+            put_varint(out, (uint32_t)(w.cycle - cycle));
+            out.push_back(w.value);
+            cycle = w.cycle;
+        }
+    }
+
+    uint8_t* header = out.data();
+    memcpy(header, "SIDD", 4);
+    header[4] = DUMP_VERSION;
+    header[5] = (uint8_t)S.sidCount;
+    header[6] = S.isNTSC ? 1 : 0;
+    for (int i = 0; i < S.sidCount; i++) {
+        header[8 + i] = S.sid[i].get_chip_model() == reSID::MOS8580 ? 1 : 0;
+        put_le16(header + 12 + i * 2, S.sidAddress[i]);
+    }
+    put_le32(header + 20, (uint32_t)frames.size());
+    put_le32(header + 24, loopFrame);
+    put_le32(header + 28, loopOffset);
+    put_le32(header + 32, initWrites);
+
+    audio_set_subtune(S.currentSubtune);
+    return (int)out.size();
+}
+
+// The dump made by the last audio_dump_capture.
+EMSCRIPTEN_KEEPALIVE
+const uint8_t* audio_dump_data() { return S.dumpCapture.data(); }
+
 // ---- Metadata accessors ----
 
 EMSCRIPTEN_KEEPALIVE
@@ -994,12 +3324,49 @@ double audio_get_play_time() {
 EMSCRIPTEN_KEEPALIVE
 int audio_get_is_ntsc() { return S.isNTSC ? 1 : 0; }
 
+// Output quiet for this many seconds is reported as silent (default
+// SILENCE_DEFAULT_SECONDS). With skipIdle set, reSID isn't clocked while
+// the tune is silent and every voice is idle, which saves the CPU a
+// finished tune would otherwise cost; the output is held at its level.
+EMSCRIPTEN_KEEPALIVE
+void audio_set_silence_detection(double seconds, int skipIdle) {
+    S.silenceSeconds = seconds > 0.0 ? seconds : SILENCE_DEFAULT_SECONDS;
+    S.silenceSkip = skipIdle != 0;
+    if (!S.silenceSkip) S.skipping = false;
+}
+
+// Bits of audio_get_end_status
+enum EndStatus {
+    END_SILENT      = 1,   // output quiet for the silence timeout
+    END_GATES_OFF   = 2,   // every voice gated off and released to zero
+    END_VOLUME_ZERO = 4,   // every chip's volume at zero
+    END_SKIPPING    = 8,   // reSID idle, not being clocked
+};
+
+// What playback looks like at the end of the last render, as EndStatus
+// bits; a tune that has ended is silent, usually with its voices off or
+// its volume down too. 0 with nothing loaded.
+EMSCRIPTEN_KEEPALIVE
+int audio_get_end_status() {
+    if (!S.loaded) return 0;
+    return (output_silent() ? END_SILENT : 0)
+        | (chips_gates_off() ? END_GATES_OFF : 0)
+        | (chips_volume_zero() ? END_VOLUME_ZERO : 0)
+        | (S.skipping ? END_SKIPPING : 0);
+}
+
+// How long the output has been quiet, in seconds
+EMSCRIPTEN_KEEPALIVE
+double audio_get_silent_time() { return S.quietSamples / S.sampleRate; }
+
 EMSCRIPTEN_KEEPALIVE
 void audio_cleanup() {
     for (int i = 0; i < MAX_SID_CHIPS; i++) {
         S.sid[i].reset();
     }
     S.loaded = false;
+    S.renderActive = false;
+    seek_clear_index();
 }
 
 } // extern "C"
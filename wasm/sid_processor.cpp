@@ -58,8 +58,48 @@ extern "C" {
     };
 #pragma pack(pop)
 
+    // Kinds of reclaimable range within the SID's load range. Each kind
+    // includes the ones before it (never-used memory is also dead after init).
+    enum ReclaimKind {
+        RECLAIM_NEVER_USED = 0,
+        RECLAIM_DEAD_AFTER_INIT = 1,
+        RECLAIM_DEAD_AFTER_FRAME0 = 2,
+        RECLAIM_KIND_COUNT = 3
+    };
+
+    // Runs shorter than this are not worth reporting as reclaimable.
+    static const uint32_t MIN_RECLAIM_RUN = 16;
+
+    // How the CIA timer driven play rate behaves across the tune.
+    enum SpeedProfile {
+        SPEED_NONE = 0,          // No song programs the timer (one call per frame)
+        SPEED_CONSTANT = 1,      // Every song runs at the same timer rate
+        SPEED_PER_SUBTUNE = 2,   // Rate differs between songs, fixed within each
+        SPEED_CHANGING = 3       // At least one song reprograms the timer while playing
+    };
+
+    // Effective timer latch from a given play call onwards.
+    struct TimerChange {
+        uint32_t playCall;
+        uint16_t latch;
+    };
+
+    struct SongSpeed {
+        uint16_t ciaTimer;       // Latch in effect for the most play calls (0 = none)
+        uint8_t callsPerFrame;
+        std::vector<TimerChange> changes;
+    };
+
+    struct MemoryRange {
+        uint16_t start;
+        uint16_t end; // inclusive
+    };
+
     struct AnalysisResults {
         std::set<uint16_t> modifiedAddresses;
+        // Subset of modifiedAddresses that a play call writes and a later play
+        // call reads back: the minimal set an extra play call must preserve.
+        std::set<uint16_t> liveAddresses;
         std::set<uint8_t> zeroPageUsed;
 
         uint32_t sidRegisterWrites[32];
@@ -75,8 +115,44 @@ extern "C" {
         uint16_t ciaTimerValue;
         bool ciaTimerDetected;
         uint32_t maxCycles;
+
+        // Latest epoch each address was touched in across all songs
+        // (0 = never, 1 = init, 2 + N = play call N).
+        uint16_t lastUse[65536];
+        std::vector<MemoryRange> reclaimRanges[RECLAIM_KIND_COUNT];
+
+        // Zero-page use interval (first/last epoch, as lastUse), ZeroPageFlag
+        // bits (and the two the solver tests), and per-instruction zero-page
+        // operand spans, for the ZP solver.
+        uint16_t zpFirstUse[256];
+        uint8_t zpFlags[256];
+        bool zpPointer[256];
+        bool zpUnpatchable[256];
+
+        // Where instructions started, and what they read as data, across all
+        // songs: the ZP solver decodes onward from here into untraced code.
+        bool instructionStart[65536];
+        bool dataRead[65536];
+        uint16_t zpOperandSpan[65536];
+
+        std::vector<SongSpeed> songSpeeds;
+        uint8_t speedProfile;
+    };
+
+    struct ZPPatch {
+        uint16_t address;
+        uint8_t value;
     };
 
+    // Zero-page relocation solver: reserved bytes in, remap + operand patches
+    // out. unverifiedCount counts patches in code the analysis never ran.
+    struct {
+        bool reserved[256];
+        uint8_t remap[256];
+        std::vector<ZPPatch> patches;
+        uint32_t unverifiedCount;
+    } zpSolver;
+
     struct {
         SIDHeader header;
         uint8_t* fileBuffer;
@@ -106,6 +182,20 @@ extern "C" {
     extern void cpu_restore_memory(uint8_t* buffer);
     extern void cpu_reset_state_only();
     extern uint32_t cpu_get_last_execution_cycles();
+    extern void cpu_begin_epoch(uint8_t phase);
+    extern bool cpu_is_play_live(uint16_t address);
+    extern uint16_t cpu_get_last_use(uint16_t address);
+    extern uint16_t cpu_get_first_use(uint16_t address);
+    extern uint16_t cpu_get_zp_operand_span(uint16_t address);
+    extern uint8_t cpu_get_zp_flags(uint8_t zp);
+    extern bool cpu_is_zp_pointer(uint8_t zp);
+    extern bool cpu_is_zp_unpatchable(uint8_t zp);
+    extern bool cpu_is_instruction_start(uint16_t address);
+    extern bool cpu_is_data_read(uint16_t address);
+    extern uint8_t cpu_read_memory(uint16_t address);
+    extern uint32_t cpu_get_timer_write_count();
+    extern uint32_t cpu_get_timer_write_epoch(uint32_t index);
+    extern uint16_t cpu_get_timer_write_latch(uint32_t index);
 
     // SID header values are stored big-endian on disk; the WASM host is
     // little-endian, so byte-swap after loading.
@@ -135,6 +225,7 @@ extern "C" {
         sidState.cleanMagicID.clear();
 
         sidState.analysis.modifiedAddresses.clear();
+        sidState.analysis.liveAddresses.clear();
         sidState.analysis.zeroPageUsed.clear();
         memset(sidState.analysis.sidRegisterWrites, 0, sizeof(sidState.analysis.sidRegisterWrites));
         sidState.analysis.codeBytes = 0;
@@ -223,6 +314,24 @@ extern "C" {
         return 0;
     }
 
+    // Play calls per video frame for a CIA timer latch. The timer underflows
+    // every latch + 1 cycles.
+    static uint8_t calls_per_frame_for_timer(uint16_t latch) {
+        // PAL: 312 lines * 63 cycles = 19656 cycles/frame.
+        // NTSC: 263 lines * 65 cycles = 17095 cycles/frame.
+        double cyclesPerFrame = 19656.0;
+
+        if (sidState.header.version >= 2) {
+            uint16_t flags = sidState.header.flags;
+            if ((flags & 0x0C) == 0x08) { // NTSC
+                cyclesPerFrame = 17095.0;
+            }
+        }
+
+        double freq = cyclesPerFrame / (latch + 1.0);
+        return (uint8_t)std::min(16, std::max(1, (int)(freq + 0.5)));
+    }
+
     // Emulate init + `frameCount` play calls per song, accumulating memory,
     // SID register, and timing statistics. progressCallback may be null.
     EMSCRIPTEN_KEEPALIVE
@@ -232,6 +341,7 @@ extern "C" {
         }
 
         sidState.analysis.modifiedAddresses.clear();
+        sidState.analysis.liveAddresses.clear();
         sidState.analysis.zeroPageUsed.clear();
         memset(sidState.analysis.sidRegisterWrites, 0, sizeof(sidState.analysis.sidRegisterWrites));
         sidState.analysis.codeBytes = 0;
@@ -243,6 +353,17 @@ extern "C" {
         sidState.analysis.ciaTimerValue = 0;
         sidState.analysis.ciaTimerDetected = false;
         sidState.analysis.maxCycles = 0;
+        memset(sidState.analysis.lastUse, 0, sizeof(sidState.analysis.lastUse));
+        memset(sidState.analysis.zpFirstUse, 0, sizeof(sidState.analysis.zpFirstUse));
+        memset(sidState.analysis.zpFlags, 0, sizeof(sidState.analysis.zpFlags));
+        memset(sidState.analysis.zpPointer, 0, sizeof(sidState.analysis.zpPointer));
+        memset(sidState.analysis.zpUnpatchable, 0, sizeof(sidState.analysis.zpUnpatchable));
+        memset(sidState.analysis.instructionStart, 0, sizeof(sidState.analysis.instructionStart));
+        memset(sidState.analysis.dataRead, 0, sizeof(sidState.analysis.dataRead));
+        memset(sidState.analysis.zpOperandSpan, 0, sizeof(sidState.analysis.zpOperandSpan));
+        for (int kind = 0; kind < RECLAIM_KIND_COUNT; kind++) {
+            sidState.analysis.reclaimRanges[kind].clear();
+        }
 
         // Snapshot memory after initial load so each song can start from
         // an identical baseline.
@@ -260,6 +381,11 @@ extern "C" {
         cpu_save_memory(cleanMemorySnapshot);
 
         uint16_t songsToAnalyze = sidState.header.songs;
+        bool allInitsCompleted = true;
+        std::vector<bool> songPlayed(songsToAnalyze, false);  // init completed and play ran
+
+        sidState.analysis.songSpeeds.assign(songsToAnalyze, SongSpeed{ 0, 1, {} });
+        sidState.analysis.speedProfile = SPEED_NONE;
 
         for (uint16_t songNum = 1; songNum <= songsToAnalyze; songNum++) {
             cpu_restore_memory(cleanMemorySnapshot);
@@ -275,16 +401,21 @@ extern "C" {
 
             cpu_set_tracking(true);
 
+            cpu_begin_epoch(0); // PHASE_INIT
             if (!cpu_execute_function(sidState.header.initAddress, 100000)) {
+                allInitsCompleted = false;
                 continue;
             }
 
             cpu_set_record_writes(true);
 
+            uint32_t playCalls = 0;
             for (uint32_t frame = 0; frame < frameCount; frame++) {
+                cpu_begin_epoch(1); // PHASE_PLAY
                 if (!cpu_execute_function(sidState.header.playAddress, 20000)) {
                     break;
                 }
+                playCalls++;
 
                 uint32_t cycles = cpu_get_last_execution_cycles();
                 if (cycles > sidState.analysis.maxCycles) {
@@ -298,6 +429,8 @@ extern "C" {
                 }
             }
 
+            songPlayed[songNum - 1] = playCalls > 0;
+
             // Accumulate per-song results before the next iteration overwrites them.
             for (uint32_t addr = 0; addr < 65536; addr++) {
                 uint8_t access = cpu_get_memory_access(addr);
@@ -310,6 +443,34 @@ extern "C" {
                     }
                 }
 
+                uint16_t lastUse = cpu_get_last_use(addr);
+                if (lastUse > sidState.analysis.lastUse[addr]) {
+                    sidState.analysis.lastUse[addr] = lastUse;
+                }
+
+                sidState.analysis.instructionStart[addr] |= cpu_is_instruction_start(addr);
+                sidState.analysis.dataRead[addr] |= cpu_is_data_read(addr);
+
+                uint16_t zpSpan = cpu_get_zp_operand_span(addr);
+                if (zpSpan > sidState.analysis.zpOperandSpan[addr]) {
+                    sidState.analysis.zpOperandSpan[addr] = zpSpan;
+                }
+
+                if (addr < 256) {
+                    uint16_t firstUse = cpu_get_first_use(addr);
+                    uint16_t& merged = sidState.analysis.zpFirstUse[addr];
+                    if (firstUse != 0 && (merged == 0 || firstUse < merged)) {
+                        merged = firstUse;
+                    }
+                    sidState.analysis.zpFlags[addr] |= cpu_get_zp_flags(addr);
+                    sidState.analysis.zpPointer[addr] |= cpu_is_zp_pointer(addr);
+                    sidState.analysis.zpUnpatchable[addr] |= cpu_is_zp_unpatchable(addr);
+                }
+
+                if (cpu_is_play_live(addr)) {
+                    sidState.analysis.liveAddresses.insert(addr);
+                }
+
                 // Code-vs-data only matters for the SID's own loaded range.
                 if (addr >= sidState.header.loadAddress &&
                     addr < sidState.header.loadAddress + musicSize) {
@@ -326,40 +487,103 @@ extern "C" {
                 sidState.analysis.sidRegisterWrites[reg] += cpu_get_sid_writes(reg);
             }
 
-            // CIA timer only needs to be detected once across all songs.
-            if (!sidState.analysis.ciaTimerDetected) {
-                extern uint8_t cpu_get_cia_timer_lo();
-                extern uint8_t cpu_get_cia_timer_hi();
-                extern bool cpu_get_cia_timer_written();
-
-                if (cpu_get_cia_timer_written()) {
-                    uint8_t ciaTimerLo = cpu_get_cia_timer_lo();
-                    uint8_t ciaTimerHi = cpu_get_cia_timer_hi();
-
-                    if (ciaTimerLo != 0 || ciaTimerHi != 0) {
-                        uint16_t timerValue = ciaTimerLo | (ciaTimerHi << 8);
-                        // PAL: 312 lines * 63 cycles = 19656 cycles/frame.
-                        // NTSC: 263 lines * 65 cycles = 17095 cycles/frame.
-                        double cyclesPerFrame = 19656.0;
-
-                        if (sidState.header.version >= 2) {
-                            uint16_t flags = sidState.header.flags;
-                            if ((flags & 0x0C) == 0x08) { // NTSC
-                                cyclesPerFrame = 17095.0;
-                            }
-                        }
-
-                        double freq = cyclesPerFrame / timerValue;
-                        sidState.analysis.numCallsPerFrame = (uint8_t)std::min(16, std::max(1, (int)(freq + 0.5)));
-                        sidState.analysis.ciaTimerValue = timerValue;
-                        sidState.analysis.ciaTimerDetected = true;
-                    }
+            // Follow the timer latch across this song's play calls. Play call N
+            // runs in epoch 2 + N, and a write made in an earlier epoch sets
+            // the rate it is called at.
+            SongSpeed& speed = sidState.analysis.songSpeeds[songNum - 1];
+            std::vector<std::pair<uint16_t, uint32_t>> callsAtLatch;
+            uint32_t timerWriteCount = cpu_get_timer_write_count();
+            uint32_t nextWrite = 0;
+            uint16_t latch = 0;
+            for (uint32_t call = 0; call < playCalls; call++) {
+                while (nextWrite < timerWriteCount && cpu_get_timer_write_epoch(nextWrite) < 2 + call) {
+                    latch = cpu_get_timer_write_latch(nextWrite++);
+                }
+                if (latch == 0) {
+                    continue;
+                }
+
+                if (speed.changes.empty() || speed.changes.back().latch != latch) {
+                    speed.changes.push_back({ call, latch });
+                }
+
+                auto it = std::find_if(callsAtLatch.begin(), callsAtLatch.end(),
+                    [latch](const std::pair<uint16_t, uint32_t>& entry) { return entry.first == latch; });
+                if (it == callsAtLatch.end()) {
+                    callsAtLatch.push_back({ latch, 1 });
+                }
+                else {
+                    it->second++;
+                }
+            }
+
+            // The song's rate is the latch most play calls ran at.
+            uint32_t bestCalls = 0;
+            for (const auto& entry : callsAtLatch) {
+                if (entry.second > bestCalls) {
+                    bestCalls = entry.second;
+                    speed.ciaTimer = entry.first;
                 }
             }
+            if (speed.ciaTimer != 0) {
+                speed.callsPerFrame = calls_per_frame_for_timer(speed.ciaTimer);
+            }
         }
 
         free(cleanMemorySnapshot);
 
+        // Summarise the per-song rates. The single-value results describe the
+        // default (start) song. A song that never reached a play call has no
+        // rate, so it cannot differ from the others.
+        bool anyTimer = false;
+        bool anyChanging = false;
+        bool songsDiffer = false;
+        const SongSpeed* firstPlayed = nullptr;
+        for (uint16_t song = 0; song < songsToAnalyze; song++) {
+            const SongSpeed& speed = sidState.analysis.songSpeeds[song];
+            anyTimer = anyTimer || speed.ciaTimer != 0;
+            anyChanging = anyChanging || speed.changes.size() > 1;
+            if (!songPlayed[song]) continue;
+            if (!firstPlayed) firstPlayed = &speed;
+            songsDiffer = songsDiffer || speed.ciaTimer != firstPlayed->ciaTimer;
+        }
+        if (anyChanging) {
+            sidState.analysis.speedProfile = SPEED_CHANGING;
+        }
+        else if (songsDiffer) {
+            sidState.analysis.speedProfile = SPEED_PER_SUBTUNE;
+        }
+        else if (anyTimer) {
+            sidState.analysis.speedProfile = SPEED_CONSTANT;
+        }
+
+        if (songsToAnalyze > 0) {
+            uint16_t startSong = std::min<uint16_t>(std::max<uint16_t>(sidState.header.startSong, 1), songsToAnalyze);
+            const SongSpeed& defaultSpeed = sidState.analysis.songSpeeds[startSong - 1];
+            sidState.analysis.numCallsPerFrame = defaultSpeed.callsPerFrame;
+            sidState.analysis.ciaTimerValue = defaultSpeed.ciaTimer;
+            sidState.analysis.ciaTimerDetected = defaultSpeed.ciaTimer != 0;
+        }
+
+        // Collect runs of the load range whose last use falls at or before
+        // each kind's cut-off epoch. A song whose init did not complete left
+        // no use map, so nothing can be reported as reclaimable.
+        uint32_t loadStart = sidState.header.loadAddress;
+        uint32_t loadEnd = std::min<uint32_t>(loadStart + musicSize, 0x10000);
+        for (int kind = 0; allInitsCompleted && kind < RECLAIM_KIND_COUNT; kind++) {
+            uint32_t runStart = loadStart;
+            for (uint32_t addr = loadStart; addr <= loadEnd; addr++) {
+                bool dead = addr < loadEnd && sidState.analysis.lastUse[addr] <= kind;
+                if (dead) {
+                    continue;
+                }
+                if (addr - runStart >= MIN_RECLAIM_RUN) {
+                    sidState.analysis.reclaimRanges[kind].push_back({ (uint16_t)runStart, (uint16_t)(addr - 1) });
+                }
+                runStart = addr + 1;
+            }
+        }
+
         return 0;
     }
 
@@ -393,6 +617,17 @@ extern "C" {
         }
     }
 
+    // Raw C64 music bytes of the loaded file (after any embedded load
+    // address). C++ only, for sid_relocator.cpp.
+    const uint8_t* sid_get_music_data(uint32_t* size) {
+        if (!sidState.isLoaded) {
+            *size = 0;
+            return nullptr;
+        }
+        *size = sidState.fileSize - sidState.dataStart;
+        return sidState.fileBuffer + sidState.dataStart;
+    }
+
     EMSCRIPTEN_KEEPALIVE
         void sid_set_header_string(int field, const char* value) {
         if (!sidState.isLoaded) return;
@@ -486,6 +721,43 @@ extern "C" {
         return *it;
     }
 
+    EMSCRIPTEN_KEEPALIVE
+        uint32_t sid_get_live_count() {
+        return sidState.analysis.liveAddresses.size();
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+        uint32_t sid_get_live_address(uint32_t index) {
+        if (index >= sidState.analysis.liveAddresses.size()) {
+            return 0xFFFF;
+        }
+
+        auto it = sidState.analysis.liveAddresses.begin();
+        std::advance(it, index);
+        return *it;
+    }
+
+    // Reclaimable ranges of the given ReclaimKind, in ascending order.
+    EMSCRIPTEN_KEEPALIVE
+        uint32_t sid_get_reclaim_range_count(int kind) {
+        if (kind < 0 || kind >= RECLAIM_KIND_COUNT) return 0;
+        return sidState.analysis.reclaimRanges[kind].size();
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+        uint16_t sid_get_reclaim_range_start(int kind, uint32_t index) {
+        if (kind < 0 || kind >= RECLAIM_KIND_COUNT) return 0;
+        if (index >= sidState.analysis.reclaimRanges[kind].size()) return 0;
+        return sidState.analysis.reclaimRanges[kind][index].start;
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+        uint16_t sid_get_reclaim_range_end(int kind, uint32_t index) {
+        if (kind < 0 || kind >= RECLAIM_KIND_COUNT) return 0;
+        if (index >= sidState.analysis.reclaimRanges[kind].size()) return 0;
+        return sidState.analysis.reclaimRanges[kind][index].end;
+    }
+
     EMSCRIPTEN_KEEPALIVE
         uint32_t sid_get_zp_count() {
         return sidState.analysis.zeroPageUsed.size();
@@ -502,6 +774,345 @@ extern "C" {
         return *it;
     }
 
+    // Zero-page use interval: first and last epoch the byte was touched in
+    // (0 = never, 1 = init, 2 + N = play call N), over all songs.
+    EMSCRIPTEN_KEEPALIVE
+        uint16_t sid_get_zp_first_use(uint8_t zp) {
+        return sidState.analysis.zpFirstUse[zp];
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+        uint16_t sid_get_zp_last_use(uint8_t zp) {
+        return sidState.analysis.lastUse[zp];
+    }
+
+    // ZeroPageFlag bits: 1 = pointer low byte, 2 = cannot be relocated.
+    EMSCRIPTEN_KEEPALIVE
+        uint8_t sid_get_zp_flags(uint8_t zp) {
+        return sidState.analysis.zpFlags[zp];
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+        void sid_zp_clear_reserved() {
+        memset(zpSolver.reserved, 0, sizeof(zpSolver.reserved));
+    }
+
+    // Mark a zero-page byte as needed by the visualizer.
+    EMSCRIPTEN_KEEPALIVE
+        void sid_zp_reserve(uint8_t zp) {
+        zpSolver.reserved[zp] = true;
+    }
+
+    // Byte of the loaded file at a C64 address inside it.
+    static uint8_t file_byte(uint32_t address) {
+        return sidState.fileBuffer[sidState.dataStart + address - sidState.header.loadAddress];
+    }
+
+    struct UntracedInstruction {
+        uint16_t address;
+        bool guessed;   // only reached by guessing, see find_untraced_code
+    };
+
+    // Instructions in the loaded file that analysis never ran but decoding
+    // reaches from code it did: fall-through, both sides of each branch, and
+    // JMP/JSR targets. Code reached only through a jump table has no such
+    // path, so decoding then also guesses that whatever follows a routine's
+    // RTS/RTI/JMP is another routine, marking what it finds as `guessed`.
+    // Decoding stops at an illegal opcode, at bytes read as data, at code
+    // that was modified while running, and where an instruction would
+    // overlap one that ran.
+    static std::vector<UntracedInstruction> find_untraced_code(uint32_t loadStart, uint32_t loadEnd) {
+        const AnalysisResults& analysis = sidState.analysis;
+        std::vector<UntracedInstruction> untraced;
+        std::vector<bool> visited(loadEnd - loadStart);
+        std::vector<uint32_t> pending;
+        std::vector<uint32_t> guesses;
+        for (uint32_t addr = loadStart; addr < loadEnd; addr++) {
+            if (analysis.instructionStart[addr]) {
+                visited[addr - loadStart] = true;
+                pending.push_back(addr);
+            }
+        }
+
+        bool guessing = false;
+        while (!pending.empty() || !guesses.empty()) {
+            if (pending.empty()) {
+                guessing = true;
+                uint32_t guess = guesses.back();
+                guesses.pop_back();
+                if (visited[guess - loadStart]) continue;
+                visited[guess - loadStart] = true;
+                pending.push_back(guess);
+            }
+            uint32_t addr = pending.back();
+            pending.pop_back();
+
+            const OpcodeInfo& info = opcodeTable[file_byte(addr)];
+            uint32_t length = info.size ? info.size : 1;
+            if (addr + length > loadEnd || analysis.modifiedAddresses.count(addr)) continue;
+            if (!analysis.instructionStart[addr]) {
+                if (info.illegal) continue;
+                bool data = false;
+                for (uint32_t i = 0; i < length; i++) {
+                    data = data || analysis.dataRead[addr + i] || (i > 0 && analysis.instructionStart[addr + i]);
+                }
+                if (data) continue;
+                untraced.push_back({ (uint16_t)addr, guessing });
+            }
+
+            const char* mnemonic = info.mnemonic;
+            bool fallsThrough = strcmp(mnemonic, "rts") != 0 && strcmp(mnemonic, "rti") != 0 &&
+                strcmp(mnemonic, "jmp") != 0 && strcmp(mnemonic, "brk") != 0;
+            uint32_t next[2] = { fallsThrough ? addr + length : loadEnd, loadEnd };
+            if (!fallsThrough && addr + length < loadEnd) {
+                guesses.push_back(addr + length);
+            }
+            if (info.mode == MODE_RELATIVE) {
+                next[1] = (uint16_t)(addr + 2 + (int8_t)file_byte(addr + 1));
+            }
+            else if (info.mode == MODE_ABSOLUTE && (strcmp(mnemonic, "jmp") == 0 || strcmp(mnemonic, "jsr") == 0)) {
+                next[1] = file_byte(addr + 1) | (file_byte(addr + 2) << 8);
+            }
+            for (uint32_t target : next) {
+                if (target >= loadStart && target < loadEnd && !visited[target - loadStart]) {
+                    visited[target - loadStart] = true;
+                    pending.push_back(target);
+                }
+            }
+        }
+        return untraced;
+    }
+
+    // Move the tune's zero-page footprint off the reserved bytes, touching as
+    // little as possible. Bytes that must stay adjacent (pointer pairs and the
+    // reach of indexed accesses) move together as one block, and only blocks
+    // holding a reserved byte are moved. Zero-page operands in code analysis
+    // never ran are found by decoding: plain and pointer operands of bytes the
+    // trace also used are patched too (see sid_get_zp_unverified_count); bytes
+    // only such code uses, and the base of an indexed operand, whose reach is
+    // unknown, are pinned. Returns the number of bytes moved, -1 if no SID
+    // is loaded, or -2 if some conflicts could not be resolved (the remap and
+    // patches then cover the rest).
+    EMSCRIPTEN_KEEPALIVE
+        int sid_zp_solve() {
+        for (int i = 0; i < 256; i++) {
+            zpSolver.remap[i] = (uint8_t)i;
+        }
+        zpSolver.patches.clear();
+        zpSolver.unverifiedCount = 0;
+
+        if (!sidState.isLoaded) {
+            return -1;
+        }
+
+        const AnalysisResults& analysis = sidState.analysis;
+        uint32_t loadStart = sidState.header.loadAddress;
+        uint32_t loadEnd = std::min<uint32_t>(loadStart + (sidState.fileSize - sidState.dataStart), 0x10000);
+
+        bool used[256];
+        bool unmovable[256];
+        bool linked[256]; // linked[b]: b and b + 1 must stay adjacent
+        for (int b = 0; b < 256; b++) {
+            used[b] = analysis.lastUse[b] != 0;
+            unmovable[b] = b < 2 || analysis.zpUnpatchable[b]; // b < 2: CPU port
+            linked[b] = analysis.zpPointer[b];
+        }
+        unmovable[0xFF] = unmovable[0xFF] || linked[0xFF];
+
+        // An instruction can be patched if it lies in the loaded file and
+        // neither its opcode nor operand was written while running.
+        auto patchable = [&](uint32_t instr) {
+            uint32_t size = opcodeTable[cpu_read_memory(instr)].size;
+            if (instr < loadStart || instr + size > loadEnd) return false;
+            for (uint32_t i = 0; i < size; i++) {
+                if (analysis.modifiedAddresses.count(instr + i)) return false;
+            }
+            return true;
+        };
+
+        for (uint32_t instr = 0; instr < 65536; instr++) {
+            uint16_t span = analysis.zpOperandSpan[instr];
+            if (span == 0) continue;
+
+            uint8_t base = cpu_read_memory((instr + 1) & 0xFFFF);
+            bool ok = patchable(instr);
+            for (uint32_t b = base; b < base + span; b++) {
+                if (b > 0xFF) {
+                    // Reaches past $FF: the whole run is pinned in place.
+                    for (uint32_t p = base; p < 256; p++) unmovable[p] = true;
+                    break;
+                }
+                used[b] = true;
+                if (!ok) unmovable[b] = true;
+                if (b + 1 < base + span) linked[b] = true;
+            }
+            if (!ok && instr >= loadStart && instr + 1 < loadEnd) {
+                // Self-modified operand: also pin the byte the file names.
+                unmovable[file_byte(instr + 1)] = true;
+            }
+        }
+
+        // Untraced code may be only partly found (e.g. a handler reached
+        // through a jump table), so a byte only it uses stays where it is.
+        bool traced[256];
+        memcpy(traced, used, sizeof(traced));
+        std::vector<uint16_t> untracedOperands;
+        for (const UntracedInstruction& untraced : find_untraced_code(loadStart, loadEnd)) {
+            uint16_t instr = untraced.address;
+            const OpcodeInfo& info = opcodeTable[file_byte(instr)];
+            bool pageZero = info.size == 3 && file_byte(instr + 2) == 0;
+            uint32_t span = 0;
+            bool indexed = false;
+            switch (info.mode) {
+            case MODE_ZERO_PAGE: span = 1; break;
+            case MODE_INDIRECT_Y: span = 2; break;
+            case MODE_ABSOLUTE: span = pageZero ? 1 : 0; break;
+            case MODE_INDIRECT: span = pageZero ? 2 : 0; break;
+            case MODE_ZERO_PAGE_X:
+            case MODE_ZERO_PAGE_Y:
+            case MODE_INDIRECT_X: indexed = true; break;
+            case MODE_ABSOLUTE_X:
+            case MODE_ABSOLUTE_Y: indexed = pageZero; break;
+            default: break;
+            }
+
+            if (span == 0 && !indexed) continue;
+            uint8_t base = file_byte(instr + 1);
+
+            // A guess may be data, so it never adds uses or patches; it only
+            // keeps the bytes it might name from moving.
+            if (untraced.guessed) {
+                uint32_t reach = std::max<uint32_t>(span, 1);
+                for (uint32_t b = base; b < base + reach && b < 256; b++) unmovable[b] = true;
+                continue;
+            }
+            if (indexed) {
+                used[base] = true;
+                unmovable[base] = true;
+                continue;
+            }
+            if (base + span > 0x100) {
+                for (uint32_t p = base; p < 256; p++) unmovable[p] = true;
+                continue;
+            }
+
+            bool ok = patchable(instr);
+            for (uint32_t b = base; b < base + span; b++) {
+                used[b] = true;
+                if (!ok || !traced[b]) unmovable[b] = true;
+                if (b + 1 < base + span) linked[b] = true;
+            }
+            if (ok) untracedOperands.push_back(instr);
+        }
+
+        // Blocks are maximal runs of linked bytes.
+        struct Block { int start; int length; };
+        std::vector<Block> conflicts;
+        for (int b = 0; b < 256; ) {
+            int end = b;
+            while (end < 255 && linked[end]) end++;
+
+            bool conflict = false;
+            for (int i = b; i <= end; i++) {
+                if (used[i] && zpSolver.reserved[i]) conflict = true;
+            }
+            if (conflict) {
+                conflicts.push_back({ b, end - b + 1 });
+            }
+            b = end + 1;
+        }
+
+        // Place the largest blocks first, first fit from $02.
+        std::stable_sort(conflicts.begin(), conflicts.end(),
+            [](const Block& a, const Block& b) { return a.length > b.length; });
+
+        bool taken[256];
+        for (int b = 0; b < 256; b++) {
+            taken[b] = b < 2 || used[b] || zpSolver.reserved[b];
+        }
+
+        int delta[256] = { 0 };
+        int moved = 0;
+        bool unresolved = false;
+        for (const Block& block : conflicts) {
+            bool pinned = false;
+            for (int i = block.start; i < block.start + block.length; i++) {
+                if (unmovable[i]) pinned = true;
+            }
+
+            int target = -1;
+            for (int t = 2; !pinned && t + block.length <= 256; t++) {
+                bool fits = true;
+                for (int i = t; i < t + block.length && fits; i++) {
+                    if (taken[i]) fits = false;
+                }
+                if (fits) {
+                    target = t;
+                    break;
+                }
+            }
+
+            if (target < 0) {
+                unresolved = true;
+                continue;
+            }
+
+            for (int i = 0; i < block.length; i++) {
+                taken[target + i] = true;
+                delta[block.start + i] = target - block.start;
+                zpSolver.remap[block.start + i] = (uint8_t)(target + i);
+            }
+            moved += block.length;
+        }
+
+        for (uint32_t instr = 0; instr < 65536; instr++) {
+            if (analysis.zpOperandSpan[instr] == 0) continue;
+            uint8_t base = cpu_read_memory((instr + 1) & 0xFFFF);
+            if (delta[base] != 0) {
+                zpSolver.patches.push_back({ (uint16_t)(instr + 1), (uint8_t)(base + delta[base]) });
+            }
+        }
+        for (uint16_t instr : untracedOperands) {
+            uint8_t base = file_byte(instr + 1);
+            if (delta[base] != 0) {
+                zpSolver.patches.push_back({ (uint16_t)(instr + 1), (uint8_t)(base + delta[base]) });
+                zpSolver.unverifiedCount++;
+            }
+        }
+
+        return unresolved ? -2 : moved;
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+        uint8_t sid_get_zp_remap(uint8_t zp) {
+        return zpSolver.remap[zp];
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+        uint32_t sid_get_zp_patch_count() {
+        return zpSolver.patches.size();
+    }
+
+    // C64 address of a patched operand byte; 0 if out of range.
+    EMSCRIPTEN_KEEPALIVE
+        uint16_t sid_get_zp_patch_address(uint32_t index) {
+        if (index >= zpSolver.patches.size()) return 0;
+        return zpSolver.patches[index].address;
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+        uint8_t sid_get_zp_patch_value(uint32_t index) {
+        if (index >= zpSolver.patches.size()) return 0;
+        return zpSolver.patches[index].value;
+    }
+
+    // Patches the last solve made in code analysis never ran; no replay of
+    // the analysis window exercises them.
+    EMSCRIPTEN_KEEPALIVE
+        uint32_t sid_get_zp_unverified_count() {
+        return zpSolver.unverifiedCount;
+    }
+
     EMSCRIPTEN_KEEPALIVE
         uint32_t sid_get_code_bytes() {
         return sidState.analysis.codeBytes;
@@ -574,6 +1185,47 @@ extern "C" {
         return sidState.analysis.ciaTimerValue;
     }
 
+    // SpeedProfile: 0 = no timer, 1 = constant, 2 = per subtune, 3 = changing.
+    EMSCRIPTEN_KEEPALIVE
+        uint8_t sid_get_speed_profile() {
+        return sidState.analysis.speedProfile;
+    }
+
+    // Per-song (0-based) rate: play calls per frame and the dominant latch.
+    EMSCRIPTEN_KEEPALIVE
+        uint8_t sid_get_song_calls_per_frame(uint16_t song) {
+        if (song >= sidState.analysis.songSpeeds.size()) return 1;
+        return sidState.analysis.songSpeeds[song].callsPerFrame;
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+        uint16_t sid_get_song_cia_timer(uint16_t song) {
+        if (song >= sidState.analysis.songSpeeds.size()) return 0;
+        return sidState.analysis.songSpeeds[song].ciaTimer;
+    }
+
+    // Timeline of effective latch values for a song: from play call
+    // `sid_get_song_timer_change_call` onwards the latch is `..._latch`.
+    EMSCRIPTEN_KEEPALIVE
+        uint32_t sid_get_song_timer_change_count(uint16_t song) {
+        if (song >= sidState.analysis.songSpeeds.size()) return 0;
+        return sidState.analysis.songSpeeds[song].changes.size();
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+        uint32_t sid_get_song_timer_change_call(uint16_t song, uint32_t index) {
+        if (song >= sidState.analysis.songSpeeds.size()) return 0;
+        const auto& changes = sidState.analysis.songSpeeds[song].changes;
+        return index < changes.size() ? changes[index].playCall : 0;
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+        uint16_t sid_get_song_timer_change_latch(uint16_t song, uint32_t index) {
+        if (song >= sidState.analysis.songSpeeds.size()) return 0;
+        const auto& changes = sidState.analysis.songSpeeds[song].changes;
+        return index < changes.size() ? changes[index].latch : 0;
+    }
+
     EMSCRIPTEN_KEEPALIVE
         uint32_t sid_get_max_cycles() {
         return sidState.analysis.maxCycles;
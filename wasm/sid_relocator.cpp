@@ -0,0 +1,681 @@
+// sid_relocator.cpp - In-WASM SID relocation for SIDwinder.
+// Moves the loaded PSID tune to a new page-aligned address without an
+// external assembler: absolute operands are found by decoding the code,
+// execution decides which data bytes are address high bytes, those are
+// patched, and the result is verified by replaying both tunes and comparing
+// their SID register write streams frame by frame.
+
+#include <emscripten/emscripten.h>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <vector>
+#include <set>
+#include "opcodes.h"
+
+extern "C" {
+
+    // CPU functions imported from cpu6510_wasm.cpp.
+    extern void cpu_init();
+    extern void cpu_set_tracking(bool enabled);
+    extern void cpu_write_memory(uint16_t address, uint8_t value);
+    extern uint8_t cpu_read_memory(uint16_t address);
+    extern int cpu_execute_function(uint16_t address, uint32_t maxCycles);
+    extern void cpu_save_memory(uint8_t* buffer);
+    extern void cpu_restore_memory(uint8_t* buffer);
+    extern void cpu_reset_state_only();
+    extern void cpu_set_accumulator(uint8_t value);
+    extern void cpu_set_xreg(uint8_t value);
+    extern void cpu_set_yreg(uint8_t value);
+    extern uint8_t cpu_get_sp();
+    extern uint8_t cpu_get_a();
+    extern uint8_t cpu_get_x();
+    extern uint8_t cpu_get_y();
+    extern void cpu_set_observers(void (*stepObserver)(uint16_t), void (*writeObserver)(uint16_t, uint8_t));
+
+    // SID functions imported from sid_processor.cpp.
+    extern uint16_t sid_get_header_value(int field);
+    extern const uint8_t* sid_get_music_data(uint32_t* size);
+
+    // Same per-call cycle budgets as sid_analyze.
+    static const uint32_t INIT_CYCLE_LIMIT = 100000;
+    static const uint32_t PLAY_CYCLE_LIMIT = 20000;
+
+    // What an instruction does to the register/memory origins.
+    enum OriginEffect : uint8_t {
+        EFFECT_NONE,
+        EFFECT_LOAD_A,
+        EFFECT_LOAD_X,
+        EFFECT_LOAD_Y,
+        EFFECT_LOAD_AX,
+        EFFECT_STORE_A,
+        EFFECT_STORE_X,
+        EFFECT_STORE_Y,
+        EFFECT_TAX,
+        EFFECT_TAY,
+        EFFECT_TXA,
+        EFFECT_TYA,
+        EFFECT_PLA,
+        EFFECT_ARITH_A,     // ADC/SBC: keeps whichever side looks like a page
+        EFFECT_RMW_KEEP,    // INC/DEC memory: the byte keeps its origin
+        EFFECT_CLOBBER_A,
+        EFFECT_CLOBBER_X,
+        EFFECT_CLOBBER_AX,
+        EFFECT_COMPARE_A,
+        EFFECT_COMPARE_X,
+        EFFECT_COMPARE_Y,
+        EFFECT_RTS,
+        EFFECT_RTI,
+        EFFECT_JUMP         // JMP/JSR: the operand is a target, not data
+    };
+
+    // Relocation state. `origin` maps every byte of C64 memory (and A/X/Y)
+    // to the offset in the music data its value was copied from, or -1.
+    struct {
+        bool effectsBuilt;
+        uint8_t effects[256];
+
+        int32_t origin[65536];
+        int32_t originA;
+        int32_t originX;
+        int32_t originY;
+        int32_t pendingWriteOrigin;
+        std::vector<uint8_t> isHighByte;
+        std::vector<uint8_t> isSidData;   // value reached a SID register
+        std::vector<uint8_t> isOpcode;    // traced as an instruction's first byte
+        std::vector<uint8_t> isDataRead;  // traced as an instruction's data operand
+        std::vector<uint8_t> isUnverified;  // operand of code the trace never ran
+        // Origins of two page-valued bytes compared with each other (e.g.
+        // CPY #>tableEnd against a pointer high byte), packed first << 32 |
+        // second: if one is a high byte, so is the other.
+        std::set<uint64_t> comparePairs;
+
+        uint16_t rangeStart;
+        uint32_t rangeEnd;     // exclusive
+        uint8_t firstPage;     // lowest page a high byte may legitimately name
+        uint8_t lastPage;
+
+        // Verification: one FNV-1a hash of the SID writes per play call.
+        uint32_t frameHash;
+
+        std::vector<uint8_t> data;
+        uint16_t loadAddress;
+        uint16_t initAddress;
+        uint16_t playAddress;
+        uint32_t patchCount;
+        uint32_t unverifiedCount;
+        uint32_t untracedCount;
+        int ambiguousOffset;
+        int mismatchSong;
+        int mismatchFrame;
+    } relocState;
+
+    static void build_effect_table() {
+        struct { const char* mnemonic; OriginEffect effect; } table[] = {
+            {"lda", EFFECT_LOAD_A}, {"ldx", EFFECT_LOAD_X}, {"ldy", EFFECT_LOAD_Y}, {"lax", EFFECT_LOAD_AX},
+            {"sta", EFFECT_STORE_A}, {"stx", EFFECT_STORE_X}, {"sty", EFFECT_STORE_Y}, {"pha", EFFECT_STORE_A},
+            {"tax", EFFECT_TAX}, {"tay", EFFECT_TAY}, {"txa", EFFECT_TXA}, {"tya", EFFECT_TYA},
+            {"pla", EFFECT_PLA}, {"adc", EFFECT_ARITH_A}, {"sbc", EFFECT_ARITH_A},
+            {"inc", EFFECT_RMW_KEEP}, {"dec", EFFECT_RMW_KEEP},
+            {"and", EFFECT_CLOBBER_A}, {"ora", EFFECT_CLOBBER_A}, {"eor", EFFECT_CLOBBER_A},
+            {"tsx", EFFECT_CLOBBER_X},
+            {"slo", EFFECT_CLOBBER_AX}, {"rla", EFFECT_CLOBBER_AX}, {"sre", EFFECT_CLOBBER_AX},
+            {"rra", EFFECT_CLOBBER_AX}, {"isc", EFFECT_CLOBBER_AX}, {"anc", EFFECT_CLOBBER_AX},
+            {"alr", EFFECT_CLOBBER_AX}, {"arr", EFFECT_CLOBBER_AX}, {"xaa", EFFECT_CLOBBER_AX},
+            {"las", EFFECT_CLOBBER_AX}, {"axs", EFFECT_CLOBBER_AX},
+            {"cmp", EFFECT_COMPARE_A}, {"cpx", EFFECT_COMPARE_X}, {"cpy", EFFECT_COMPARE_Y},
+            {"rts", EFFECT_RTS}, {"rti", EFFECT_RTI}, {"jmp", EFFECT_JUMP}, {"jsr", EFFECT_JUMP}
+        };
+
+        for (int op = 0; op < 256; op++) {
+            const OpcodeInfo& info = opcodeTable[op];
+            relocState.effects[op] = EFFECT_NONE;
+            for (const auto& entry : table) {
+                if (strcmp(info.mnemonic, entry.mnemonic) == 0) {
+                    relocState.effects[op] = entry.effect;
+                    break;
+                }
+            }
+            // Shifts/rotates only touch a register in accumulator mode.
+            if (info.mode == MODE_ACCUMULATOR) {
+                relocState.effects[op] = EFFECT_CLOBBER_A;
+            }
+        }
+        relocState.effectsBuilt = true;
+    }
+
+    static inline bool in_range(uint16_t address) {
+        return address >= relocState.rangeStart && address < relocState.rangeEnd;
+    }
+
+    static inline bool is_tune_page(uint8_t value) {
+        return value >= relocState.firstPage && value <= relocState.lastPage;
+    }
+
+    // The byte at `highAddress` supplied the high byte of an address; if that
+    // address (before or after indexing) lies in the tune, its source moves.
+    static inline void consume_high_byte(uint16_t highAddress, uint16_t base, uint16_t effective) {
+        if (!in_range(base) && !in_range(effective)) return;
+        int32_t source = relocState.origin[highAddress];
+        if (source >= 0) {
+            relocState.isHighByte[source] = 1;
+        }
+    }
+
+    static inline void mark_data_read(uint16_t address) {
+        if (in_range(address)) {
+            relocState.isDataRead[address - relocState.rangeStart] = 1;
+        }
+    }
+
+    static uint16_t read_pointer(uint8_t zp) {
+        return cpu_read_memory(zp) | (cpu_read_memory((uint8_t)(zp + 1)) << 8);
+    }
+
+    // Called before each instruction: record high-byte uses, then update
+    // the register origins (loads read memory before any write happens).
+    static void relocator_step(uint16_t pc) {
+        uint8_t opcode = cpu_read_memory(pc);
+        const OpcodeInfo& info = opcodeTable[opcode];
+        uint16_t operand = cpu_read_memory(pc + 1) | (cpu_read_memory(pc + 2) << 8);
+        uint8_t x = cpu_get_x();
+        uint8_t y = cpu_get_y();
+        uint8_t sp = cpu_get_sp();
+
+        bool hasAddress = true;
+        uint16_t address = 0;
+        int32_t operandOrigin = -1;
+
+        switch (info.mode) {
+        case MODE_IMMEDIATE:
+            hasAddress = false;
+            operandOrigin = relocState.origin[(uint16_t)(pc + 1)];
+            break;
+        case MODE_ZERO_PAGE:
+            address = operand & 0xFF;
+            break;
+        case MODE_ZERO_PAGE_X:
+            address = (operand + x) & 0xFF;
+            break;
+        case MODE_ZERO_PAGE_Y:
+            address = (operand + y) & 0xFF;
+            break;
+        case MODE_ABSOLUTE:
+            address = operand;
+            consume_high_byte(pc + 2, operand, address);
+            break;
+        case MODE_ABSOLUTE_X:
+            address = operand + x;
+            consume_high_byte(pc + 2, operand, address);
+            break;
+        case MODE_ABSOLUTE_Y:
+            address = operand + y;
+            consume_high_byte(pc + 2, operand, address);
+            break;
+        case MODE_INDIRECT: {
+            // JMP (vector): the vector's high byte obeys the page-wrap bug.
+            hasAddress = false;
+            consume_high_byte(pc + 2, operand, operand);
+            uint16_t vectorHigh = (operand & 0xFF00) | ((operand + 1) & 0xFF);
+            uint16_t target = cpu_read_memory(operand) | (cpu_read_memory(vectorHigh) << 8);
+            consume_high_byte(vectorHigh, target, target);
+            mark_data_read(operand);
+            mark_data_read(vectorHigh);
+            break;
+        }
+        case MODE_INDIRECT_X: {
+            uint8_t zp = (uint8_t)(operand + x);
+            address = read_pointer(zp);
+            consume_high_byte((uint8_t)(zp + 1), address, address);
+            break;
+        }
+        case MODE_INDIRECT_Y: {
+            uint8_t zp = (uint8_t)operand;
+            uint16_t base = read_pointer(zp);
+            address = base + y;
+            consume_high_byte((uint8_t)(zp + 1), base, address);
+            break;
+        }
+        default:
+            hasAddress = false;
+            break;
+        }
+
+        if (hasAddress) {
+            operandOrigin = relocState.origin[address];
+        }
+
+        // What ran is code; what it loaded, compared or modified is data.
+        if (in_range(pc)) {
+            relocState.isOpcode[pc - relocState.rangeStart] = 1;
+        }
+        uint8_t effect = relocState.effects[opcode];
+        if (hasAddress && effect != EFFECT_STORE_A && effect != EFFECT_STORE_X &&
+            effect != EFFECT_STORE_Y && effect != EFFECT_JUMP) {
+            mark_data_read(address);
+        }
+
+        relocState.pendingWriteOrigin = -1;
+
+        switch (effect) {
+        case EFFECT_LOAD_A:   relocState.originA = operandOrigin; break;
+        case EFFECT_LOAD_X:   relocState.originX = operandOrigin; break;
+        case EFFECT_LOAD_Y:   relocState.originY = operandOrigin; break;
+        case EFFECT_LOAD_AX:  relocState.originA = relocState.originX = operandOrigin; break;
+        case EFFECT_STORE_A:  relocState.pendingWriteOrigin = relocState.originA; break;
+        case EFFECT_STORE_X:  relocState.pendingWriteOrigin = relocState.originX; break;
+        case EFFECT_STORE_Y:  relocState.pendingWriteOrigin = relocState.originY; break;
+        case EFFECT_TAX:      relocState.originX = relocState.originA; break;
+        case EFFECT_TAY:      relocState.originY = relocState.originA; break;
+        case EFFECT_TXA:      relocState.originA = relocState.originX; break;
+        case EFFECT_TYA:      relocState.originA = relocState.originY; break;
+        case EFFECT_PLA:
+            relocState.originA = relocState.origin[0x0100 + (uint8_t)(sp + 1)];
+            break;
+        case EFFECT_ARITH_A: {
+            // base + offset: follow the side whose value is a tune page.
+            uint8_t value = hasAddress ? cpu_read_memory(address) : (uint8_t)operand;
+            if (is_tune_page(value) && !is_tune_page(cpu_get_a())) {
+                relocState.originA = operandOrigin;
+            }
+            break;
+        }
+        case EFFECT_RMW_KEEP:
+            relocState.pendingWriteOrigin = operandOrigin;
+            break;
+        case EFFECT_CLOBBER_A:  relocState.originA = -1; break;
+        case EFFECT_CLOBBER_X:  relocState.originX = -1; break;
+        case EFFECT_CLOBBER_AX: relocState.originA = relocState.originX = -1; break;
+        case EFFECT_COMPARE_A:
+        case EFFECT_COMPARE_X:
+        case EFFECT_COMPARE_Y: {
+            int32_t registerOrigin = effect == EFFECT_COMPARE_A ? relocState.originA
+                : effect == EFFECT_COMPARE_X ? relocState.originX : relocState.originY;
+            uint8_t registerValue = effect == EFFECT_COMPARE_A ? cpu_get_a()
+                : effect == EFFECT_COMPARE_X ? x : y;
+            uint8_t value = hasAddress ? cpu_read_memory(address) : (uint8_t)operand;
+            if (registerOrigin >= 0 && operandOrigin >= 0 && registerOrigin != operandOrigin &&
+                is_tune_page(registerValue) && is_tune_page(value)) {
+                relocState.comparePairs.insert(((uint64_t)registerOrigin << 32) | (uint32_t)operandOrigin);
+            }
+            break;
+        }
+        case EFFECT_RTS: {
+            uint16_t high = 0x0100 + (uint8_t)(sp + 2);
+            uint16_t target = (cpu_read_memory(0x0100 + (uint8_t)(sp + 1)) | (cpu_read_memory(high) << 8)) + 1;
+            consume_high_byte(high, target, target);
+            break;
+        }
+        case EFFECT_RTI: {
+            uint16_t high = 0x0100 + (uint8_t)(sp + 3);
+            uint16_t target = cpu_read_memory(0x0100 + (uint8_t)(sp + 2)) | (cpu_read_memory(high) << 8);
+            consume_high_byte(high, target, target);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    static void relocator_write(uint16_t address, uint8_t value) {
+        int32_t source = relocState.pendingWriteOrigin;
+        if (source >= 0 && address >= 0xD400 && address <= 0xD7FF) {
+            relocState.isSidData[source] = 1;
+        }
+        relocState.origin[address] = source;
+    }
+
+    static void verify_write(uint16_t address, uint8_t value) {
+        if (address < 0xD400 || address > 0xD7FF) return;
+        uint32_t hash = relocState.frameHash;
+        hash = (hash ^ (address & 0xFF)) * 16777619u;
+        hash = (hash ^ ((address >> 8) & 0xFF)) * 16777619u;
+        hash = (hash ^ value) * 16777619u;
+        relocState.frameHash = hash;
+    }
+
+    static void trace_write(uint16_t address, uint8_t value) {
+        relocator_write(address, value);
+        verify_write(address, value);
+    }
+
+    // Run init + `frames` play calls of one song from the given snapshot.
+    // With `hashes`, the SID writes of each call (init = entry 0) are
+    // appended to it. Returns false if init or a play call does not return.
+    static bool run_song(uint8_t* snapshot, uint16_t song, uint16_t initAddress, uint16_t playAddress,
+                         uint32_t frames, std::vector<uint32_t>* hashes) {
+        cpu_restore_memory(snapshot);
+        cpu_reset_state_only();
+        cpu_set_accumulator(song);
+        cpu_set_xreg(song);
+        cpu_set_yreg(song);
+
+        relocState.originA = relocState.originX = relocState.originY = -1;
+        relocState.pendingWriteOrigin = -1;
+        relocState.frameHash = 2166136261u;
+
+        if (!cpu_execute_function(initAddress, INIT_CYCLE_LIMIT)) {
+            return false;
+        }
+        if (hashes) hashes->push_back(relocState.frameHash);
+
+        for (uint32_t frame = 0; frame < frames; frame++) {
+            relocState.frameHash = 2166136261u;
+            if (!cpu_execute_function(playAddress, PLAY_CYCLE_LIMIT)) {
+                return false;
+            }
+            if (hashes) hashes->push_back(relocState.frameHash);
+        }
+        return true;
+    }
+
+    // Load `data` at `address` into a clean CPU and snapshot it.
+    static void load_snapshot(uint8_t* snapshot, const uint8_t* data, uint32_t size, uint16_t address) {
+        cpu_init();
+        cpu_set_tracking(false);
+        for (uint32_t i = 0; i < size; i++) {
+            cpu_write_memory(address + i, data[i]);
+        }
+        cpu_save_memory(snapshot);
+    }
+
+    // Detach the observers and leave the CPU holding the original tune, as
+    // sid_load does, so later analysis/disassembly sees unrelocated memory.
+    static void finish_relocation(uint8_t* snapshot, const uint8_t* music, uint32_t size, uint16_t loadAddress) {
+        cpu_set_observers(nullptr, nullptr);
+        free(snapshot);
+        cpu_init();
+        cpu_set_tracking(false);
+        for (uint32_t i = 0; i < size; i++) {
+            cpu_write_memory(loadAddress + i, music[i]);
+        }
+    }
+
+    // Decode the code statically, starting from every instruction the trace
+    // ran and following both sides of branches, jumps and calls into the
+    // tune. This reaches code the traced frames never executed (a rarely
+    // taken branch, a routine only a later pattern calls), whose operands no
+    // trace can see; for code that did run, the traced addresses decide.
+    // In such code, the high byte of each absolute or indirect operand inside
+    // the tune is marked. An indexed operand based below the tune may or may
+    // not reach into it, so it is left alone and only counted as unverified.
+    // Decoding stops at anything that looks like data: an illegal opcode, or
+    // bytes the trace read as data or split mid-instruction. Bytes left
+    // neither code nor data (e.g. a handler reached only through a jump
+    // table) are counted in untracedCount.
+    static void decode_code(const uint8_t* music, uint32_t size) {
+        std::vector<uint8_t> visited(relocState.isOpcode);
+        std::vector<uint8_t> covered(relocState.isDataRead);
+        std::vector<uint32_t> pending;
+        for (uint32_t i = 0; i < size; i++) {
+            if (visited[i]) pending.push_back(i);
+        }
+
+        while (!pending.empty()) {
+            uint32_t offset = pending.back();
+            pending.pop_back();
+
+            const OpcodeInfo& info = opcodeTable[music[offset]];
+            uint8_t length = info.size ? info.size : 1;
+            bool executed = relocState.isOpcode[offset];
+            if (!executed) {
+                if (info.illegal || offset + length > size) continue;
+                bool data = false;
+                for (uint8_t i = 0; i < length; i++) {
+                    data |= relocState.isDataRead[offset + i] || (i > 0 && relocState.isOpcode[offset + i]);
+                }
+                if (data) continue;
+            }
+            for (uint8_t i = 0; i < length && offset + i < size; i++) {
+                covered[offset + i] = 1;
+            }
+
+            uint16_t pc = (uint16_t)(relocState.rangeStart + offset);
+            uint16_t operand = length == 3 && offset + 2 < size ? music[offset + 1] | (music[offset + 2] << 8) : 0;
+            bool indexed = info.mode == MODE_ABSOLUTE_X || info.mode == MODE_ABSOLUTE_Y;
+            bool absolute = indexed || info.mode == MODE_ABSOLUTE || info.mode == MODE_INDIRECT;
+            if (!executed && absolute) {
+                if (in_range(operand)) {
+                    relocState.isHighByte[offset + 2] = 1;
+                    relocState.isUnverified[offset + 2] = 1;
+                }
+                else if (indexed && operand < relocState.rangeStart && operand + 0xFF >= relocState.rangeStart) {
+                    relocState.unverifiedCount++;
+                }
+            }
+
+            // Successors: the next instruction unless control never falls
+            // through, a branch's target, and a JMP/JSR target in the tune.
+            uint8_t effect = relocState.effects[music[offset]];
+            bool fallsThrough = effect != EFFECT_RTS && effect != EFFECT_RTI &&
+                strcmp(info.mnemonic, "jmp") != 0 && strcmp(info.mnemonic, "brk") != 0;
+            uint32_t next[2] = { fallsThrough ? offset + length : size, size };
+            if (info.mode == MODE_RELATIVE && length == 2 && offset + 1 < size) {
+                uint16_t target = (uint16_t)(pc + 2 + (int8_t)music[offset + 1]);
+                if (in_range(target)) next[1] = target - relocState.rangeStart;
+            } else if (effect == EFFECT_JUMP && info.mode == MODE_ABSOLUTE && in_range(operand)) {
+                next[1] = operand - relocState.rangeStart;
+            }
+            for (uint32_t target : next) {
+                if (target < size && !visited[target]) {
+                    visited[target] = 1;
+                    pending.push_back(target);
+                }
+            }
+        }
+
+        for (uint32_t i = 0; i < size; i++) {
+            if (!covered[i]) relocState.untracedCount++;
+        }
+    }
+
+    // Relocate the loaded tune to `newLoadAddress` and verify `frames` play
+    // calls of every song against the original. Patches in code those calls
+    // never run, and bytes the trace could not classify at all, are reported
+    // by sid_get_relocation_unverified_count / _untraced_count.
+    // Returns 0 on success, or:
+    //   -1 no SID loaded
+    //   -2 move is not a whole number of pages
+    //   -3 target range wraps, overlaps $D000-$DFFF or starts below $0200
+    //   -4 tune has no play address (interrupt-driven PSID)
+    //   -5 a byte is used both as an address high byte and as SID data
+    //      (see sid_get_relocation_ambiguous_offset)
+    //   -6 original tune did not complete init/play for some song
+    //   -7 relocated tune's SID writes differ (see sid_get_relocation_mismatch_*)
+    EMSCRIPTEN_KEEPALIVE
+        int sid_relocate(uint16_t newLoadAddress, uint32_t frames) {
+        uint32_t size = 0;
+        const uint8_t* music = sid_get_music_data(&size);
+        if (!music) return -1;
+
+        relocState.data.clear();
+        relocState.patchCount = 0;
+        relocState.unverifiedCount = 0;
+        relocState.untracedCount = 0;
+        relocState.ambiguousOffset = -1;
+        relocState.mismatchSong = -1;
+        relocState.mismatchFrame = -1;
+
+        uint16_t loadAddress = sid_get_header_value(1);
+        uint16_t initAddress = sid_get_header_value(2);
+        uint16_t playAddress = sid_get_header_value(3);
+        uint16_t songs = sid_get_header_value(4);
+        if (initAddress == 0) initAddress = loadAddress;
+
+        if ((newLoadAddress & 0xFF) != (loadAddress & 0xFF)) return -2;
+        uint32_t newEnd = (uint32_t)newLoadAddress + size;
+        if (newLoadAddress < 0x0200 || newEnd > 0x10000 || (newLoadAddress < 0xE000 && newEnd > 0xD000)) {
+            return -3;
+        }
+        if (playAddress == 0) return -4;
+
+        if (!relocState.effectsBuilt) build_effect_table();
+
+        relocState.rangeStart = loadAddress;
+        relocState.rangeEnd = (uint32_t)loadAddress + size;
+        relocState.firstPage = (uint8_t)((loadAddress >> 8) - 1);
+        relocState.lastPage = (uint8_t)((relocState.rangeEnd - 1) >> 8);
+        relocState.isHighByte.assign(size, 0);
+        relocState.isSidData.assign(size, 0);
+        relocState.isOpcode.assign(size, 0);
+        relocState.isDataRead.assign(size, 0);
+        relocState.isUnverified.assign(size, 0);
+        relocState.comparePairs.clear();
+        int pageDelta = (newLoadAddress >> 8) - (loadAddress >> 8);
+
+        uint8_t* snapshot = (uint8_t*)malloc(65536);
+
+        // Pass 1: trace the original to find the code it runs and the data
+        // high bytes it uses, and keep its SID writes as the reference for
+        // verification.
+        std::vector<std::vector<uint32_t>> reference(songs);
+        load_snapshot(snapshot, music, size, loadAddress);
+        cpu_set_observers(relocator_step, trace_write);
+
+        bool completed = true;
+        for (uint16_t song = 0; song < songs && completed; song++) {
+            for (uint32_t i = 0; i < 65536; i++) {
+                int32_t offset = (int32_t)i - loadAddress;
+                relocState.origin[i] = (offset >= 0 && offset < (int32_t)size) ? offset : -1;
+            }
+            completed = run_song(snapshot, song, initAddress, playAddress, frames, &reference[song]);
+        }
+
+        if (!completed) {
+            finish_relocation(snapshot, music, size, loadAddress);
+            return -6;
+        }
+
+        // Code operands come from decoding, which also covers code the
+        // traced frames never reached.
+        decode_code(music, size);
+
+        // Spread high-byte marks across compare pairs until nothing changes.
+        bool spread = true;
+        while (spread) {
+            spread = false;
+            for (uint64_t pair : relocState.comparePairs) {
+                uint8_t& first = relocState.isHighByte[pair >> 32];
+                uint8_t& second = relocState.isHighByte[pair & 0xFFFFFFFF];
+                if (first != second) {
+                    first = second = 1;
+                    spread = true;
+                }
+            }
+        }
+
+        // A byte that is both an address high byte and a value written to the
+        // SID (e.g. code read back as a note table) cannot be patched safely.
+        for (uint32_t i = 0; i < size; i++) {
+            if (relocState.isHighByte[i] && relocState.isSidData[i] && is_tune_page(music[i])) {
+                relocState.ambiguousOffset = (int)i;
+                finish_relocation(snapshot, music, size, loadAddress);
+                return -5;
+            }
+        }
+
+        // Patch: every page-valued high byte moves by the page delta.
+        relocState.data.assign(music, music + size);
+        for (uint32_t i = 0; i < size; i++) {
+            if (relocState.isHighByte[i] && is_tune_page(relocState.data[i])) {
+                relocState.data[i] = (uint8_t)(relocState.data[i] + pageDelta);
+                relocState.patchCount++;
+                if (relocState.isUnverified[i]) relocState.unverifiedCount++;
+            }
+        }
+
+        uint16_t delta = newLoadAddress - loadAddress;
+        relocState.loadAddress = newLoadAddress;
+        relocState.initAddress = in_range(initAddress) ? initAddress + delta : initAddress;
+        relocState.playAddress = in_range(playAddress) ? playAddress + delta : playAddress;
+
+        // Pass 2: replay the relocated tune and compare the SID writes.
+        load_snapshot(snapshot, relocState.data.data(), size, newLoadAddress);
+        cpu_set_observers(nullptr, verify_write);
+
+        int result = 0;
+        std::vector<uint32_t> hashes;
+        for (uint16_t song = 0; song < songs && result == 0; song++) {
+            hashes.clear();
+            run_song(snapshot, song, relocState.initAddress, relocState.playAddress, frames, &hashes);
+            for (size_t frame = 0; frame < reference[song].size(); frame++) {
+                if (frame >= hashes.size() || hashes[frame] != reference[song][frame]) {
+                    relocState.mismatchSong = song;
+                    relocState.mismatchFrame = (int)frame - 1;  // -1 = init
+                    result = -7;
+                    break;
+                }
+            }
+        }
+
+        finish_relocation(snapshot, music, size, loadAddress);
+
+        if (result != 0) {
+            relocState.data.clear();
+        }
+        return result;
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+        uint8_t* sid_get_relocated_data() {
+        return relocState.data.empty() ? nullptr : relocState.data.data();
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+        uint32_t sid_get_relocated_size() {
+        return (uint32_t)relocState.data.size();
+    }
+
+    // field: 1 = load, 2 = init, 3 = play (as sid_get_header_value).
+    EMSCRIPTEN_KEEPALIVE
+        uint16_t sid_get_relocated_address(int field) {
+        if (relocState.data.empty()) return 0;
+
+        switch (field) {
+        case 1: return relocState.loadAddress;
+        case 2: return relocState.initAddress;
+        case 3: return relocState.playAddress;
+        default: return 0;
+        }
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+        uint32_t sid_get_relocation_patch_count() {
+        return relocState.patchCount;
+    }
+
+    // Operands in code the verification replay never executed, found by
+    // decoding alone and not checked by pass 2: those patched, plus indexed
+    // ones based just below the tune, which were left unpatched.
+    EMSCRIPTEN_KEEPALIVE
+        uint32_t sid_get_relocation_unverified_count() {
+        return relocState.unverifiedCount;
+    }
+
+    // Bytes of the tune that were neither decoded as code nor read as data:
+    // any address they hold was not patched and the replay never used it.
+    EMSCRIPTEN_KEEPALIVE
+        uint32_t sid_get_relocation_untraced_count() {
+        return relocState.untracedCount;
+    }
+
+    // Offset into the music data of the first ambiguous byte after
+    // sid_relocate returned -5.
+    EMSCRIPTEN_KEEPALIVE
+        int sid_get_relocation_ambiguous_offset() {
+        return relocState.ambiguousOffset;
+    }
+
+    // Song (0-based) and play call (-1 = init) of the first mismatch after
+    // sid_relocate returned -7.
+    EMSCRIPTEN_KEEPALIVE
+        int sid_get_relocation_mismatch_song() {
+        return relocState.mismatchSong;
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+        int sid_get_relocation_mismatch_frame() {
+        return relocState.mismatchFrame;
+    }
+
+}